@@ -17,24 +17,15 @@
 
 import QtQuick
 
+// Drawn from the shared countdown state, no animation of its own
 Rectangle {
     id: root
-    width: initialWidth
+    width: initialWidth * fraction
 
     property bool runnig: false
-    property int expireTimeout: 0
+    // Share of the timeout left
+    property real fraction: 1
     property int initialWidth: parent.width
 
-    function restart() {
-        anim.restart();
-    }
-
     visible: runnig
-
-    PropertyAnimation {
-        id: anim
-        target: root; property: "width"; from: initialWidth; to: 0
-        duration: expireTimeout < 0 ? 0 : expireTimeout
-        running: root.runnig && expireTimeout > 0
-    }
 }
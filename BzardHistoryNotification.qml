@@ -39,6 +39,18 @@ Rectangle {
         anchors.right: parent.right
     }
 
+    Text {
+        id: timeText
+        // Entries from old logs carry no time
+        text: timestamp.getTime() > 0 ? Qt.formatDateTime(timestamp, "dd.MM hh:mm") : ""
+        color: appText.color
+        font.pointSize: appText.font.pointSize
+        anchors.left: icon.right
+        anchors.leftMargin: sideMargin
+        anchors.bottomMargin: topMargin
+        anchors.bottom: parent.bottom
+    }
+
     Text {
         id: titleText
         text: title
@@ -44,6 +44,7 @@ BzardPopup {
     property int calcWidth: Screen.desktopAvailableWidth / 4
 
     property int barHeight: 32
+    property bool grouped: false
 
     BzardFancyContainer {
         id: container
@@ -72,16 +73,73 @@ BzardPopup {
             }
         }
 
+        Rectangle {
+            id: searchBar
+            height: root.barHeight
+            anchors.top: bar.bottom
+            anchors.left: parent.left
+            anchors.right: parent.right
+            color: BzardThemes.historyWindowTheme.nBgColor
+
+            TextInput {
+                id: searchInput
+                visible: !root.grouped
+                anchors.top: parent.top
+                anchors.bottom: parent.bottom
+                anchors.left: parent.left
+                anchors.right: groupToggle.left
+                anchors.leftMargin: height / 4
+                anchors.rightMargin: height / 4
+                verticalAlignment: TextInput.AlignVCenter
+                clip: true
+                color: BzardThemes.historyWindowTheme.nTitleTextColor
+                font.pointSize: BzardThemes.historyWindowTheme.barFontSize ?
+                                    BzardThemes.historyWindowTheme.barFontSize :
+                                    height * 0.35
+                onTextChanged: BzardHistory.searchModel.query = text
+            }
+
+            Text {
+                text: qsTr("Search")
+                visible: searchInput.visible && !searchInput.text &&
+                         !searchInput.activeFocus
+                anchors.fill: searchInput
+                verticalAlignment: Text.AlignVCenter
+                opacity: 0.5
+                color: searchInput.color
+                font: searchInput.font
+            }
+
+            Text {
+                id: groupToggle
+                text: root.grouped ? qsTr("List") : qsTr("Group")
+                anchors.top: parent.top
+                anchors.bottom: parent.bottom
+                anchors.right: parent.right
+                anchors.rightMargin: height / 4
+                verticalAlignment: Text.AlignVCenter
+                color: searchInput.color
+                font: searchInput.font
+
+                MouseArea {
+                    anchors.fill: parent
+                    cursorShape: Qt.PointingHandCursor
+                    onClicked: root.grouped = !root.grouped
+                }
+            }
+        }
+
         ListView {
             id: listView
+            visible: !root.grouped
             highlightFollowsCurrentItem: false
             focus: true
-            anchors.top: bar.bottom
+            anchors.top: searchBar.bottom
             anchors.left: parent.left
             anchors.right: parent.right
             anchors.bottom: parent.bottom
 
-            model: BzardHistory.model
+            model: BzardHistory.searchModel
             delegate: BzardHistoryNotification {
                 width: listView.width
                 height: BzardThemes.historyWindowTheme.notificationHeight ?
@@ -101,7 +159,90 @@ BzardPopup {
                               BzardThemes.historyWindowTheme.nBodyFontSize :
                               height * 0.11111111111111111111
                 onRemoveNotification: {
-                    BzardHistory.remove(listView.index)
+                    BzardHistory.searchModel.remove(index)
+                }
+            }
+        }
+
+        // Only expanded groups instantiate entry delegates
+        TreeView {
+            id: treeView
+            visible: root.grouped
+            clip: true
+            anchors.top: searchBar.bottom
+            anchors.left: parent.left
+            anchors.right: parent.right
+            anchors.bottom: parent.bottom
+
+            // The grouped model is filled on first use
+            model: root.grouped ? BzardHistory.groupModel : null
+            delegate: Item {
+                id: treeDelegate
+                required property TreeView treeView
+                required property bool isTreeNode
+                required property bool expanded
+                required property bool hasChildren
+                required property int depth
+                required property int row
+                required property var model
+
+                implicitWidth: treeView.width
+                implicitHeight: depth ?
+                                    (BzardThemes.historyWindowTheme.notificationHeight ?
+                                         BzardThemes.historyWindowTheme.notificationHeight : 70) :
+                                    root.barHeight
+
+                Rectangle {
+                    visible: !treeDelegate.depth
+                    anchors.fill: parent
+                    color: BzardThemes.historyWindowTheme.barBgColor
+
+                    Text {
+                        anchors.fill: parent
+                        anchors.leftMargin: height / 4
+                        anchors.rightMargin: height / 4
+                        verticalAlignment: Text.AlignVCenter
+                        elide: Text.ElideRight
+                        color: BzardThemes.historyWindowTheme.barTextColor
+                        text: (treeDelegate.expanded ? "\u25be " : "\u25b8 ") +
+                              treeDelegate.model.application + " (" +
+                              treeDelegate.model.count + ")  " +
+                              Qt.formatDateTime(treeDelegate.model.timestamp, "dd.MM hh:mm")
+                    }
+
+                    MouseArea {
+                        anchors.fill: parent
+                        acceptedButtons: Qt.LeftButton | Qt.MiddleButton
+                        onClicked: (mouse) => {
+                            if (mouse.button === Qt.MiddleButton)
+                                BzardHistory.groupModel.remove(
+                                      treeView.index(treeDelegate.row, 0))
+                            else
+                                treeView.toggleExpanded(treeDelegate.row)
+                        }
+                    }
+                }
+
+                Loader {
+                    active: treeDelegate.depth > 0
+                    anchors.fill: parent
+                    sourceComponent: BzardHistoryNotification {
+                        readonly property string application: treeDelegate.model.application
+                        readonly property string title: treeDelegate.model.title
+                        readonly property string body: treeDelegate.model.body
+                        readonly property string iconUrl: treeDelegate.model.iconUrl
+                        readonly property var timestamp: treeDelegate.model.timestamp
+                        readonly property int index: treeDelegate.row
+
+                        color: BzardThemes.historyWindowTheme.nBgColor
+                        appColor: BzardThemes.historyWindowTheme.nAppTextColor
+                        titleColor: BzardThemes.historyWindowTheme.nTitleTextColor
+                        bodyColor: BzardThemes.historyWindowTheme.nBodyTextColor
+                        onRemoveNotification: {
+                            BzardHistory.groupModel.remove(
+                                  treeView.index(treeDelegate.row, 0))
+                        }
+                    }
                 }
             }
         }
@@ -24,47 +24,55 @@ BzardPopup {
     dropDuration: container.dropDuration
 
     property int notification_id: 0
+    // Height the layout is scaled to, and the most the popup may take
+    property int referenceHeight: 0
     property alias appName: container.appName
     property alias body: container.body
     property alias iconUrl: container.iconUrl
     property alias buttons: container.buttons
-    property alias expireTimeout: expiration_controller.timeout
+    property alias expireTimeout: container.timeout
+    // When the popup was asked for, to log time to its first frame
+    property double requestedAt: 0
+    property bool pooled: false
 
-    BzardExpirationController{
-        id: expiration_controller
-        onExpired: BzardNotifications.onExpired(notification_id)
-        expiration: alive && !mouseArea.containsMouse
-    }
+    height: BzardNotifications.variableHeight ?
+                Math.min(referenceHeight, container.contentHeight) :
+                referenceHeight
+    onHeightChanged: reportHeight()
+    // Pooled popups are rebound to new notifications
+    onNotification_idChanged: reportHeight()
+    Component.onCompleted: reportHeight()
 
-    MouseArea {
-        id: mouseArea
-        anchors.fill: parent
-        hoverEnabled: true
-        acceptedButtons: Qt.LeftButton | Qt.MiddleButton | Qt.RightButton
-        function onClicked (mouse) {
-            var rightPressed = mouse.button & Qt.RightButton;
-            if (rightPressed && BzardNotifications.closeAllByRightClick) {
-                BzardNotifications.onDropAll()
-            }
-            var middlePressed = mouse.button & Qt.MiddleButton;
-            if (middlePressed && BzardNotifications.closeVisibleByLeftClick) {
-                return BzardNotifications.onDropVisible()
-            }
-            var leftPressed = mouse.button & Qt.LeftButton;
-            if (leftPressed && BzardNotifications.closeByLeftClick) {
-                return BzardNotifications.onCloseButtonPressed(notification_id)
-            }
+    onFrameSwapped: {
+        if (requestedAt > 0) {
+            console.debug(popupTiming, "first frame of",
+                          pooled ? "pooled" : "new", "popup after",
+                          Date.now() - requestedAt, "ms");
+            requestedAt = 0;
         }
     }
 
-    BzardNotificationContainer {
+    LoggingCategory {
+        id: popupTiming
+        name: "bzard.popup.timing"
+        defaultLogLevel: LoggingCategory.Warning
+    }
+
+    function restartExpiration() {
+        container.restartExpiration();
+    }
+
+    function reportHeight() {
+        if (BzardNotifications.variableHeight && notification_id && height > 0)
+            BzardNotifications.onNotificationResized(notification_id, height);
+    }
+
+    BzardNotificationBody {
         id: container
-        referenceHeight: root.height
-        expireTimeout: expiration_controller.timeout - showDuration
-        expiration: expiration_controller.expiration
+        notification_id: root.notification_id
+        alive: root.alive
+        referenceHeight: root.referenceHeight
         title: root.title
         anchors.fill: parent
-        onCloseClicked: BzardNotifications.onCloseButtonPressed(notification_id)
-        onButtonClicked: BzardNotifications.onActionButtonPressed(notification_id, button)
     }
 }
@@ -0,0 +1,67 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+import QtQuick
+import bzard 1.0
+
+// Notification content shared by window and overlay popups
+BzardNotificationContainer {
+    id: root
+
+    property int notification_id: 0
+    property bool alive: false
+    property alias timeout: expiration_controller.timeout
+
+    expirationFraction: expiration_controller.remainingFraction
+    expiration: expiration_controller.expiration
+    onCloseClicked: BzardNotifications.onCloseButtonPressed(notification_id)
+    onButtonClicked: BzardNotifications.onActionButtonPressed(notification_id, button)
+
+    // After the content was replaced in place
+    function restartExpiration() {
+        expiration_controller.restart();
+    }
+
+    BzardExpirationController{
+        id: expiration_controller
+        notificationId: notification_id
+        expiration: alive && !mouseArea.containsMouse
+    }
+
+    MouseArea {
+        id: mouseArea
+        // Under the content, so buttons get their clicks first
+        z: -1
+        anchors.fill: parent
+        hoverEnabled: true
+        acceptedButtons: Qt.LeftButton | Qt.MiddleButton | Qt.RightButton
+        function onClicked (mouse) {
+            var rightPressed = mouse.button & Qt.RightButton;
+            if (rightPressed && BzardNotifications.closeAllByRightClick) {
+                BzardNotifications.onDropAll()
+            }
+            var middlePressed = mouse.button & Qt.MiddleButton;
+            if (middlePressed && BzardNotifications.closeVisibleByLeftClick) {
+                return BzardNotifications.onDropVisible()
+            }
+            var leftPressed = mouse.button & Qt.LeftButton;
+            if (leftPressed && BzardNotifications.closeByLeftClick) {
+                return BzardNotifications.onCloseButtonPressed(notification_id)
+            }
+        }
+    }
+}
@@ -30,6 +30,10 @@ BzardFancyContainer {
     signal buttonClicked(string button)
 
     property int referenceHeight: 0
+    // Height the content needs, independent of the current height
+    readonly property int contentHeight: barHeight + 2 * contentMargin +
+                                         Math.max(column.implicitHeight,
+                                                  iconAtLeftSideLoader.implicitHeight)
 
     property alias appName: bar.text
     property alias title: titleText.text
@@ -37,7 +41,7 @@ BzardFancyContainer {
     property url iconUrl: ""
     property variant buttons: undefined
 
-    property alias expireTimeout: expirationBar.expireTimeout
+    property alias expirationFraction: expirationBar.fraction
     property bool expiration: false
 
     property int barHeight: BzardThemes.notificationsTheme.barHeight ?
@@ -84,7 +88,7 @@ BzardFancyContainer {
         color: BzardThemes.notificationsTheme.expirationBarColor
         height: expirationBarHeight
         // Crutch to run animation after object created
-        runnig: expiration && root.height === root.referenceHeight && root.height > 0
+        runnig: expiration && root.height > 0
     }
 
     Component {
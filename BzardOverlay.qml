@@ -0,0 +1,77 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+import QtQuick
+import QtQuick.Window
+import bzard 1.0
+
+// One transparent window over all screens that draws every popup
+Window {
+    id: root
+    visible: inputMask.active
+    color: "transparent"
+    flags: Qt.FramelessWindowHint | Qt.Tool | Qt.WindowDoesNotAcceptFocus | Qt.BypassWindowManagerHint
+    property string layer: "notifications"
+
+    // Popups are positioned in screen coordinates minus this
+    readonly property point origin: Qt.point(bounds.x, bounds.y)
+    property rect bounds: screensBounds()
+
+    x: bounds.x
+    y: bounds.y
+    width: bounds.width
+    height: bounds.height
+
+    function screensBounds() {
+        var screens = Qt.application.screens;
+        if (screens.length === 0)
+            return Qt.rect(0, 0, 0, 0);
+        var left = screens[0].virtualX, top = screens[0].virtualY;
+        var right = left + screens[0].width, bottom = top + screens[0].height;
+        for (var i = 1; i < screens.length; ++i) {
+            left = Math.min(left, screens[i].virtualX);
+            top = Math.min(top, screens[i].virtualY);
+            right = Math.max(right, screens[i].virtualX + screens[i].width);
+            bottom = Math.max(bottom, screens[i].virtualY + screens[i].height);
+        }
+        return Qt.rect(left, top, right - left, bottom - top);
+    }
+
+    onFrameSwapped: {
+        var popups = contentItem.children;
+        for (var i = 0; i < popups.length; ++i) {
+            if (popups[i].visible && popups[i].requestedAt > 0) {
+                console.debug(popupTiming, "first frame of",
+                              popups[i].pooled ? "pooled" : "new",
+                              "overlay popup after",
+                              Date.now() - popups[i].requestedAt, "ms");
+                popups[i].requestedAt = 0;
+            }
+        }
+    }
+
+    LoggingCategory {
+        id: popupTiming
+        name: "bzard.popup.timing"
+        defaultLogLevel: LoggingCategory.Warning
+    }
+
+    BzardInputMask {
+        id: inputMask
+        layer: root.contentItem
+    }
+}
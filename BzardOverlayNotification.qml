@@ -0,0 +1,61 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+import QtQuick
+import bzard 1.0
+
+// BzardNotification drawn inside the shared overlay window
+BzardOverlayPopup {
+    id: root
+    dropDuration: container.dropDuration
+
+    property int notification_id: 0
+    property int referenceHeight: 0
+    property alias appName: container.appName
+    property alias body: container.body
+    property alias iconUrl: container.iconUrl
+    property alias buttons: container.buttons
+    property alias expireTimeout: container.timeout
+    // The overlay logs the first frame after this
+    property double requestedAt: 0
+    property bool pooled: false
+
+    height: BzardNotifications.variableHeight ?
+                Math.min(referenceHeight, container.contentHeight) :
+                referenceHeight
+    onHeightChanged: reportHeight()
+    onNotification_idChanged: reportHeight()
+    Component.onCompleted: reportHeight()
+
+    function restartExpiration() {
+        container.restartExpiration();
+    }
+
+    function reportHeight() {
+        if (BzardNotifications.variableHeight && notification_id && height > 0)
+            BzardNotifications.onNotificationResized(notification_id, height);
+    }
+
+    BzardNotificationBody {
+        id: container
+        notification_id: root.notification_id
+        alive: root.alive
+        referenceHeight: root.referenceHeight
+        title: root.title
+        anchors.fill: parent
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+import QtQuick
+
+// BzardPopup as an item of the shared overlay instead of its own window
+Item {
+    id: root
+    visible: false
+
+    property alias dropDuration: destroyTimer.interval
+    property int moveDuration: dropDuration
+    property bool alive: false
+    // Hidden and handed back with released() instead of destroyed
+    property bool recyclable: false
+    // Windows have a title, the notification content reads it
+    property string title: ""
+
+    property int _newX: x
+    property int _newY: y
+
+    /* SIGNALS */
+
+    signal released()
+
+    /* FUNCTIONS */
+
+    function show() {
+        visible = true;
+        alive = true;
+        container.animateShow();
+    }
+
+    function drop() {
+        alive = false;
+        container.animateDrop();
+        destroyTimer.start();
+    }
+
+    // Back to a hidden popup that can be bound to another notification
+    function reset() {
+        destroyTimer.stop();
+        moveAnimation.stop();
+        alive = false;
+        visible = false;
+    }
+
+    function move(newX, newY) {
+        _newX = newX;
+        _newY = newY;
+        moveAnimation.start();
+    }
+
+    /* COMPONENTS */
+
+    Timer {
+        id: destroyTimer
+        running: false
+        repeat: false
+        onTriggered: {
+            visible = false;
+            if (recyclable)
+                released();
+            else
+                root.destroy();
+        }
+    }
+
+    ParallelAnimation {
+        id: moveAnimation
+        PropertyAnimation {
+            target: root; property: "x"; to: _newX
+            duration: moveDuration
+        }
+        PropertyAnimation {
+            target: root; property: "y"; to: _newY
+            duration: moveDuration
+        }
+    }
+}
@@ -29,13 +29,20 @@ Window {
     property alias dropDuration: destroyTimer.interval
     property int moveDuration: dropDuration
     property bool alive: false
+    // Hidden and handed back with released() instead of closed
+    property bool recyclable: false
 
     property int _newX: x
     property int _newY: y
 
+    /* SIGNALS */
+
+    signal released()
+
     /* FUNCTIONS */
 
     function show() {
+        visible = true;
         alive = true;
         container.animateShow();
     }
@@ -46,6 +53,14 @@ Window {
         destroyTimer.start();
     }
 
+    // Back to a hidden popup that can be bound to another notification
+    function reset() {
+        destroyTimer.stop();
+        moveAnimation.stop();
+        alive = false;
+        visible = false;
+    }
+
     function move(newX, newY) {
         _newX = newX;
         _newY = newY;
@@ -58,7 +73,14 @@ Window {
         id: destroyTimer
         running: false
         repeat: false
-        onTriggered: close()
+        onTriggered: {
+            if (recyclable) {
+                visible = false;
+                released();
+            } else {
+                close();
+            }
+        }
     }
 
     ParallelAnimation {
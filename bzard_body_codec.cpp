@@ -0,0 +1,176 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_body_codec.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+#include <zdict.h>
+
+Q_LOGGING_CATEGORY(body_codec, "bzard.history.codec", QtWarningMsg)
+
+BzardBodyCodec::BzardBodyCodec(qsizetype threshold_)
+	  : threshold{threshold_}, compressor{ZSTD_createCCtx()},
+		decompressor{ZSTD_createDCtx()} {}
+
+bool BzardBodyCodec::shouldPack(const QString &text) const {
+	return threshold > 0 && text.size() >= threshold && compressor &&
+	       decompressor;
+}
+
+QByteArray BzardBodyCodec::pack(const QString &text) {
+	auto utf8 = text.toUtf8();
+	if (!trained)
+		addSample(utf8);
+
+	auto source = utf8.constData();
+	auto sourceSize = static_cast<size_t>(utf8.size());
+	auto capacity = ZSTD_compressBound(sourceSize);
+	QByteArray packed{static_cast<qsizetype>(capacity), Qt::Uninitialized};
+
+	auto frame = packed.data();
+	size_t size{0};
+	if (compressionDictionary)
+		size = ZSTD_compress_usingCDict(compressor.get(), frame, capacity,
+		                                source, sourceSize,
+		                                compressionDictionary.get());
+	else
+		size = ZSTD_compressCCtx(compressor.get(), frame, capacity, source,
+		                         sourceSize, COMPRESSION_LEVEL);
+	if (ZSTD_isError(size)) {
+		qWarning() << Q_FUNC_INFO << ZSTD_getErrorName(size);
+		return {};
+	}
+	// Incompressible, e.g. already encoded data: better stored as is
+	if (size >= sourceSize)
+		return {};
+	packed.resize(static_cast<qsizetype>(size));
+	packed.squeeze();
+	return packed;
+}
+
+QString BzardBodyCodec::unpack(const QByteArray &packed) const {
+	if (packed.isEmpty())
+		return {};
+
+	QElapsedTimer timer;
+	timer.start();
+
+	auto frame = packed.constData();
+	auto frameSize = static_cast<size_t>(packed.size());
+	auto contentSize = ZSTD_getFrameContentSize(frame, frameSize);
+	if (contentSize == ZSTD_CONTENTSIZE_ERROR ||
+	    contentSize == ZSTD_CONTENTSIZE_UNKNOWN)
+		return {};
+
+	QByteArray utf8{static_cast<qsizetype>(contentSize), Qt::Uninitialized};
+	auto target = utf8.data();
+	size_t size{0};
+	if (ZSTD_getDictID_fromFrame(frame, frameSize)) {
+		if (!decompressionDictionary)
+			return {};
+		size = ZSTD_decompress_usingDDict(decompressor.get(), target,
+		                                  contentSize, frame, frameSize,
+		                                  decompressionDictionary.get());
+	} else {
+		size = ZSTD_decompressDCtx(decompressor.get(), target, contentSize,
+		                           frame, frameSize);
+	}
+	if (ZSTD_isError(size)) {
+		qWarning() << Q_FUNC_INFO << ZSTD_getErrorName(size);
+		return {};
+	}
+
+	auto text = QString::fromUtf8(target, static_cast<qsizetype>(size));
+	decodeNanoseconds += timer.nsecsElapsed();
+	++decodes;
+	return text;
+}
+
+qint64 BzardBodyCodec::unpackedBytes(const QByteArray &packed) {
+	auto contentSize = ZSTD_getFrameContentSize(
+		  packed.constData(), static_cast<size_t>(packed.size()));
+	if (contentSize == ZSTD_CONTENTSIZE_ERROR ||
+	    contentSize == ZSTD_CONTENTSIZE_UNKNOWN)
+		return 0;
+	return static_cast<qint64>(contentSize);
+}
+
+double BzardBodyCodec::averageDecodeMicroseconds() const {
+	if (!decodes)
+		return 0;
+	return static_cast<double>(decodeNanoseconds) / decodes / 1000;
+}
+
+qint64 BzardBodyCodec::byteCount() const {
+	// ZSTD_sizeof_* accept null
+	auto bytes = ZSTD_sizeof_CCtx(compressor.get()) +
+	             ZSTD_sizeof_DCtx(decompressor.get()) +
+	             ZSTD_sizeof_CDict(compressionDictionary.get()) +
+	             ZSTD_sizeof_DDict(decompressionDictionary.get()) +
+	             sampleSizes.capacity() * sizeof(size_t);
+	return static_cast<qint64>(bytes) + samples.capacity();
+}
+
+void BzardBodyCodec::ZstdDeleter::operator()(ZSTD_CCtx *context) const {
+	ZSTD_freeCCtx(context);
+}
+
+void BzardBodyCodec::ZstdDeleter::operator()(ZSTD_DCtx *context) const {
+	ZSTD_freeDCtx(context);
+}
+
+void BzardBodyCodec::ZstdDeleter::operator()(ZSTD_CDict *dictionary) const {
+	ZSTD_freeCDict(dictionary);
+}
+
+void BzardBodyCodec::ZstdDeleter::operator()(ZSTD_DDict *dictionary) const {
+	ZSTD_freeDDict(dictionary);
+}
+
+void BzardBodyCodec::addSample(const QByteArray &utf8) {
+	samples += utf8;
+	sampleSizes.push_back(static_cast<size_t>(utf8.size()));
+	if (sampleSizes.size() >= TRAINING_SAMPLES ||
+	    static_cast<size_t>(samples.size()) >= TRAINING_BYTES)
+		train();
+}
+
+void BzardBodyCodec::train() {
+	trained = true;
+
+	QByteArray dictionary{static_cast<qsizetype>(DICTIONARY_BYTES),
+	                      Qt::Uninitialized};
+	auto size = ZDICT_trainFromBuffer(
+		  dictionary.data(), DICTIONARY_BYTES, samples.constData(),
+		  sampleSizes.data(), static_cast<unsigned>(sampleSizes.size()));
+	samples = {};
+	sampleSizes = {};
+	if (ZDICT_isError(size)) {
+		// Too few or too different samples; bodies stay self-contained
+		qWarning() << Q_FUNC_INFO << ZDICT_getErrorName(size);
+		return;
+	}
+
+	compressionDictionary.reset(
+		  ZSTD_createCDict(dictionary.constData(), size, COMPRESSION_LEVEL));
+	decompressionDictionary.reset(
+		  ZSTD_createDDict(dictionary.constData(), size));
+	qCDebug(body_codec) << "Trained a" << size << "byte dictionary for history bodies";
+}
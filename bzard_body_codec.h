@@ -0,0 +1,83 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+#include <zstd.h>
+
+/*
+ * Compresses long notification bodies with zstd.
+ *
+ * Bodies tend to be near-identical (CI logs, stack traces), so the first
+ * long bodies are kept as samples to train a shared dictionary; every
+ * body packed after that uses it. A packed body is one zstd frame of its
+ * UTF-8 text; the frame records its content size and whether it needs
+ * the dictionary.
+ */
+class BzardBodyCodec {
+  public:
+	// Bodies of at least threshold characters are packed; 0 packs none
+	explicit BzardBodyCodec(qsizetype threshold_);
+
+	bool shouldPack(const QString &TEXT) const;
+	// Empty when packing would not make the body smaller
+	QByteArray pack(const QString &TEXT);
+	QString unpack(const QByteArray &PACKED) const;
+
+	// UTF-8 bytes of the body, about what it takes when stored unpacked
+	static qint64 unpackedBytes(const QByteArray &PACKED);
+	double averageDecodeMicroseconds() const;
+	// Contexts, dictionaries and the training samples not yet used
+	qint64 byteCount() const;
+
+  private:
+	struct ZstdDeleter {
+		void operator()(ZSTD_CCtx *context) const;
+		void operator()(ZSTD_DCtx *context) const;
+		void operator()(ZSTD_CDict *dictionary) const;
+		void operator()(ZSTD_DDict *dictionary) const;
+	};
+
+	static constexpr auto COMPRESSION_LEVEL = 3;
+	static constexpr size_t DICTIONARY_BYTES = 16 * 1024;
+	static constexpr size_t TRAINING_SAMPLES = 64;
+	static constexpr size_t TRAINING_BYTES = 1024 * 1024;
+
+	const qsizetype threshold;
+
+	std::unique_ptr<ZSTD_CCtx, ZstdDeleter> compressor;
+	std::unique_ptr<ZSTD_DCtx, ZstdDeleter> decompressor;
+	std::unique_ptr<ZSTD_CDict, ZstdDeleter> compressionDictionary;
+	std::unique_ptr<ZSTD_DDict, ZstdDeleter> decompressionDictionary;
+
+	// Concatenated training samples, dropped once trained
+	QByteArray samples;
+	std::vector<size_t> sampleSizes;
+	bool trained{false};
+
+	mutable qint64 decodeNanoseconds{0};
+	mutable qint64 decodes{0};
+
+	void addSample(const QByteArray &UTF8);
+	void train();
+};
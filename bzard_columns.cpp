@@ -0,0 +1,154 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_columns.h"
+
+BzardColumns::BzardColumns(size_t count, Direction direction_,
+                           QScreen *screen, QObject *parent)
+	  : BzardDisposition(screen, parent), direction{direction_},
+		columns(qMax<size_t>(count, 1)) {
+	recalculateAvailableScreenGeometry();
+}
+
+BzardColumns::Optional<QPoint> BzardColumns::poses(BzardNotification::IdT id,
+                                                   QSize size) {
+	flushReflow();
+
+	// Already here, must be replaced
+	auto found = placements.constFind(id);
+	if (found != placements.cend())
+		return found->rect.topLeft();
+
+	// First fit, columns are filled from the right
+	for (size_t column = 0; column < columns.size(); ++column) {
+		auto &stack = columns[column];
+		QRect rect{QPoint{columnLeft(column, size.width()),
+		                  top(stack.extent(), size.height())},
+		           size};
+		if (!availableScreenGeometry.contains(rect))
+			continue;
+
+		stack.push(id, size.height());
+		placements.insert(id, {column, rect});
+		return {rect.topLeft()};
+	}
+	return {};
+}
+
+void BzardColumns::resize(BzardNotification::IdT id, int height) {
+	auto found = placements.find(id);
+	if (found == placements.end())
+		return;
+	if (!columns[found->column].resize(id, height))
+		return;
+
+	// A bottom-up popup moves itself, the reflow sees to that
+	found->rect.setHeight(height);
+	scheduleReflow();
+}
+
+bool BzardColumns::variableHeight() const { return true; }
+
+QPoint BzardColumns::externalWindowPosition() const {
+	// topRight() is one pixel left of the real edge, hence the - 1
+	return availableScreenGeometry.bottomRight() -
+	       QPoint{extraWindowSize.width() - 1, 0};
+}
+
+void BzardColumns::setExtraWindowSize(const QSize &value) {
+	BzardDisposition::setExtraWindowSize(value);
+	recalculateAvailableScreenGeometry();
+}
+
+void BzardColumns::setSpacing(int value) {
+	BzardDisposition::setSpacing(value);
+	recalculateAvailableScreenGeometry();
+	for (auto &column : columns)
+		column.setSpacing(value);
+	scheduleReflow();
+}
+
+void BzardColumns::remove(BzardNotification::IdT id) {
+	auto found = placements.find(id);
+	if (found == placements.end())
+		return;
+
+	columns[found->column].remove(id);
+	placements.erase(found);
+	forgetMove(id);
+	// The rest move once the event loop pass is over
+	scheduleReflow();
+}
+
+void BzardColumns::removeAll() {
+	for (auto &column : columns)
+		column.clear();
+	placements.clear();
+	cancelReflow();
+}
+
+void BzardColumns::recalculateAvailableScreenGeometry() {
+	BzardDisposition::recalculateAvailableScreenGeometry();
+	auto extraBottomMargin = extraWindowSize.height() + spacing;
+	availableScreenGeometry -= QMargins{0, 0, 0, extraBottomMargin};
+}
+
+void BzardColumns::reflow() {
+	std::vector<BzardNotification::IdT> overflow;
+	for (size_t column = 0; column < columns.size(); ++column) {
+		columns[column].reflow([&](auto id, int offset, int height) {
+			auto &rect = placements[id].rect;
+			QPoint topLeft{columnLeft(column, rect.width()),
+			               top(offset, height)};
+			if (!availableScreenGeometry.contains(
+				      QRect{topLeft, rect.size()})) {
+				overflow.push_back(id);
+			} else if (rect.topLeft() != topLeft) {
+				rect.moveTopLeft(topLeft);
+				moveTo(id, topLeft);
+			}
+		});
+	}
+
+	// Only a shrunk screen or a popup measured taller than it was placed
+	// leaves popups past the end of a column, and they are the last ones
+	// in it, so nothing else moves
+	for (auto id : overflow) {
+		columns[placements[id].column].remove(id);
+		placements.remove(id);
+		forgetMove(id);
+		emit overflowed(id);
+	}
+}
+
+void BzardColumns::relayout() {
+	for (auto &column : columns)
+		column.invalidate();
+	scheduleReflow();
+}
+
+int BzardColumns::columnLeft(size_t column, int width) const {
+	auto index = static_cast<int>(column);
+	return availableScreenGeometry.right() + 1 - (index + 1) * width -
+	       index * spacing;
+}
+
+int BzardColumns::top(int offset, int height) const {
+	if (direction == Direction::TOP_DOWN)
+		return availableScreenGeometry.top() + offset;
+	return availableScreenGeometry.bottom() + 1 - offset - height;
+}
@@ -0,0 +1,74 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <QHash>
+#include <QObject>
+#include <QPoint>
+
+#include "bzard_disposition.h"
+#include "bzard_slot_stack.h"
+
+/*
+ * Popups of any height stacked in columns from the right edge. A popup
+ * goes to the first column it fits in and stays there; removals close
+ * the gap within the column. One column is a plain top-down or
+ * bottom-up stack.
+ */
+class BzardColumns final : public BzardDisposition {
+	Q_OBJECT
+
+  public:
+	using BzardDisposition::Optional;
+	enum class Direction { TOP_DOWN, BOTTOM_UP };
+
+	BzardColumns(size_t count, Direction direction_, QScreen *screen = nullptr,
+	             QObject *parent = nullptr);
+
+	Optional<QPoint> poses(BzardNotification::IdT id, QSize size) final;
+	void resize(BzardNotification::IdT id, int height) final;
+	bool variableHeight() const final;
+
+	QPoint externalWindowPosition() const final;
+
+	void setExtraWindowSize(const QSize &value) final;
+
+	void setSpacing(int value) final;
+
+  public slots:
+	void remove(BzardNotification::IdT id) final;
+	void removeAll() final;
+
+  private:
+	struct Placement {
+		size_t column;
+		QRect rect;
+	};
+
+	const Direction direction;
+	std::vector<BzardSlotStack> columns;
+	QHash<BzardNotification::IdT, Placement> placements;
+
+	void recalculateAvailableScreenGeometry() final;
+	void reflow() final;
+	void relayout() final;
+	int columnLeft(size_t column, int width) const;
+	int top(int offset, int height) const;
+};
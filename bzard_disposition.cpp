@@ -17,16 +17,33 @@
 
 #include "bzard_disposition.h"
 
-#include <QApplication>
+#include <utility>
 
-BzardDisposition::BzardDisposition(QObject *parent)
-	  : QObject{parent}, screen_{QApplication::screens().at(0)} {
-	connect(screen_, &QScreen::availableGeometryChanged, this,
-	        &BzardDisposition::recalculateAvailableScreenGeometry);
+#include <QGuiApplication>
+
+BzardDisposition::BzardDisposition(QScreen *screen, QObject *parent)
+	  : QObject{parent},
+		screen_{screen ? screen : QGuiApplication::primaryScreen()} {
+	connect(screen_, &QScreen::availableGeometryChanged, this, [this] {
+		recalculateAvailableScreenGeometry();
+		relayout();
+	});
+
+	reflowTimer.setSingleShot(true);
+	reflowTimer.setInterval(0);
+	connect(&reflowTimer, &QTimer::timeout, this,
+	        &BzardDisposition::commitReflow);
 }
 
 const QScreen *BzardDisposition::screen() const { return screen_; }
 
+void BzardDisposition::resize(BzardNotification::IdT id, int height) {
+	Q_UNUSED(id)
+	Q_UNUSED(height)
+}
+
+bool BzardDisposition::variableHeight() const { return false; }
+
 void BzardDisposition::setExtraWindowSize(const QSize &value) {
 	extraWindowSize = value;
 }
@@ -42,3 +59,37 @@ void BzardDisposition::recalculateAvailableScreenGeometry() {
 	auto screenGeometry = screen()->availableGeometry();
 	availableScreenGeometry = screenGeometry - margins;
 }
+
+void BzardDisposition::scheduleReflow() {
+	reflowPending = true;
+	if (!reflowTimer.isActive())
+		reflowTimer.start();
+}
+
+void BzardDisposition::flushReflow() {
+	if (!reflowPending)
+		return;
+	reflowPending = false;
+	reflow();
+}
+
+void BzardDisposition::moveTo(BzardNotification::IdT id, QPoint position) {
+	moves.insert(id, position);
+}
+
+void BzardDisposition::forgetMove(BzardNotification::IdT id) {
+	moves.remove(id);
+}
+
+void BzardDisposition::cancelReflow() {
+	reflowTimer.stop();
+	reflowPending = false;
+	moves.clear();
+}
+
+void BzardDisposition::commitReflow() {
+	flushReflow();
+	MovesT committed;
+	std::swap(committed, moves);
+	emit reflowed(committed);
+}
@@ -20,11 +20,13 @@
 #include <experimental/optional>
 #include <memory>
 
+#include <QHash>
 #include <QObject>
 #include <QPoint>
 #include <QRect>
 #include <QScreen>
 #include <QSize>
+#include <QTimer>
 
 #include <bzard_notification.h>
 
@@ -33,15 +35,22 @@ class BzardDisposition : public QObject {
   public:
 	using PtrT = std::unique_ptr<BzardDisposition>;
 	template <class T> using Optional = std::experimental::optional<T>;
+	using MovesT = QHash<BzardNotification::IdT, QPoint>;
 
-	explicit BzardDisposition(QObject *parent = nullptr);
+	// Lays popups out on screen_, the primary screen if none is given
+	explicit BzardDisposition(QScreen *screen_ = nullptr,
+	                          QObject *parent = nullptr);
 	virtual ~BzardDisposition() = default;
 
 	virtual Optional<QPoint> poses(BzardNotification::IdT id, QSize size) = 0;
 
+	// Height a popup measured for its content, if heights may vary
+	virtual void resize(BzardNotification::IdT id, int height);
+	virtual bool variableHeight() const;
+
 	virtual QPoint externalWindowPosition() const = 0;
 
-	const QScreen *screen() const;
+	virtual const QScreen *screen() const;
 
 	virtual void setExtraWindowSize(const QSize &VALUE);
 
@@ -54,16 +63,46 @@ class BzardDisposition : public QObject {
 	virtual void removeAll() = 0;
 
   signals:
-	void moveNotification(BzardNotification::IdT id, QPoint position);
+	/*
+	 * Once per event loop pass after removals, with every popup moved
+	 * in it; may be empty when only space was freed
+	 */
+	void reflowed(const BzardDisposition::MovesT &MOVES);
+	// A placed popup no longer fits after its screen changed or went away,
+	// or after another one grew
+	void overflowed(BzardNotification::IdT id);
 
   protected:
-	int spacing;
+	int spacing{0};
 	QMargins margins;
 	QSize extraWindowSize{0, 0};
 	QRect availableScreenGeometry;
 
 	virtual void recalculateAvailableScreenGeometry();
 
+	/*
+	 * Reflow transaction: removals call scheduleReflow(), reflow() runs
+	 * once for all of them and reports positions through moveTo().
+	 */
+	void scheduleReflow();
+	// Positions must be settled before a new popup is placed
+	void flushReflow();
+	void moveTo(BzardNotification::IdT id, QPoint position);
+	void forgetMove(BzardNotification::IdT id);
+	void cancelReflow();
+	virtual void reflow() = 0;
+	/*
+	 * The available geometry changed under placed popups: move them to
+	 * match, through moveTo() and scheduleReflow(), and drop the ones that
+	 * no longer fit with overflowed()
+	 */
+	virtual void relayout() = 0;
+
   private:
 	const QScreen *screen_;
+	QTimer reflowTimer;
+	bool reflowPending{false};
+	MovesT moves;
+
+	void commitReflow();
 };
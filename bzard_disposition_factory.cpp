@@ -0,0 +1,71 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_disposition_factory.h"
+
+#include <QDebug>
+#include <QStringList>
+
+#include "bzard_columns.h"
+#include "bzard_grid.h"
+#include "bzard_screens.h"
+#include "bzard_top_down.h"
+
+namespace {
+BzardDisposition::PtrT make_layout(QScreen *screen, const QString &name,
+                                   uint columns) {
+	using Direction = BzardColumns::Direction;
+	if (name == "bottom_up")
+		return std::make_unique<BzardColumns>(1, Direction::BOTTOM_UP, screen);
+	if (name == "columns")
+		return std::make_unique<BzardColumns>(columns, Direction::TOP_DOWN,
+		                                      screen);
+	if (name == "grid")
+		return std::make_unique<BzardGrid>(screen);
+	if (name == "fixed_top_down")
+		return std::make_unique<BzardTopDown>(screen);
+	return std::make_unique<BzardColumns>(1, Direction::TOP_DOWN, screen);
+}
+} // namespace
+
+BzardDispositionFactory::BzardDispositionFactory()
+	  : BzardConfigurable{"popup_notifications"} {}
+
+BzardDisposition::PtrT BzardDispositionFactory::create() const {
+	auto name =
+		  config.value(CONFIG_DISPOSITION, CONFIG_DISPOSITION_DEFAULT)
+				.toString();
+	static const QStringList KNOWN{"top_down", "bottom_up", "columns", "grid",
+	                               "fixed_top_down"};
+	if (!KNOWN.contains(name))
+		qWarning() << "Unknown disposition" << name << "using"
+		           << CONFIG_DISPOSITION_DEFAULT;
+	auto columns =
+		  config.value(CONFIG_COLUMNS, CONFIG_COLUMNS_DEFAULT).toUInt();
+
+	auto screen =
+		  config.value(CONFIG_SCREEN, CONFIG_SCREEN_DEFAULT).toString();
+	auto placement = screen == "cursor" ? BzardScreens::Placement::CURSOR
+	                                    : BzardScreens::Placement::PRIMARY;
+
+	// Screens may come later, when the factory is long gone
+	return std::make_unique<BzardScreens>(
+		  [name, columns](QScreen *screen) {
+			  return make_layout(screen, name, columns);
+		  },
+		  placement);
+}
@@ -0,0 +1,38 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "bzard_config.h"
+#include "bzard_disposition.h"
+
+/*
+ * Builds the popup disposition named in the popup_notifications config,
+ * one per screen.
+ */
+class BzardDispositionFactory final : public BzardConfigurable {
+  public:
+	BzardDispositionFactory();
+
+	BzardDisposition::PtrT create() const;
+
+  private:
+	BZARD_CONFIG_VAR(DISPOSITION, "disposition", "top_down")
+	BZARD_CONFIG_VAR(COLUMNS, "columns", 2)
+	BZARD_CONFIG_VAR(SCREEN, "screen", "primary")
+
+};
@@ -17,38 +17,82 @@
 
 #include "bzard_expiration_controller.h"
 
+#include "bzard_notifications.h"
+
+BzardExpirationController::BzardExpirationController(QObject *parent)
+	  : QObject(parent), expirations{BzardNotifications::get()->expirations()} {
+	connect(expirations, &BzardExpirations::ticked, this, [this] {
+		if (expiration())
+			emit remainingFractionChanged();
+	});
+}
+
+BzardExpirationController::~BzardExpirationController() {
+	if (id)
+		expirations->remove(id);
+}
+
+int BzardExpirationController::notificationId() const {
+	return static_cast<int>(id);
+}
+
+void BzardExpirationController::setNotificationId(int notificationId) {
+	auto newId = static_cast<BzardExpirations::IdT>(notificationId);
+	if (newId == id)
+		return;
+	// Pooled popups move on to other notifications
+	if (id)
+		expirations->remove(id);
+	id = newId;
+	if (id) {
+		expirations->setTimeout(id, timeout_);
+		if (expiration_)
+			expirations->resume(id);
+	}
+
+	emit notificationIdChanged();
+	emit remainingFractionChanged();
+}
+
 bool BzardExpirationController::expiration() const {
-	return timer ? timer->isActive() : false;
+	return expiration_ && timeout_ > 0;
 }
 
 void BzardExpirationController::setExpiration(bool expiration) {
-	if (timer) {
-		if (expiration) {
-			timer->start();
-		} else {
-			timer->stop();
-		}
+	expiration_ = expiration;
+	if (id) {
+		if (expiration)
+			expirations->resume(id);
+		else
+			expirations->pause(id);
 	}
 
 	emit expirationChanged();
 }
 
 int BzardExpirationController::timeout() const {
-	return timer ? timer->interval() : 0;
+	return timeout_;
 }
 
 void BzardExpirationController::setTimeout(int timeout) {
-	if (timeout) {
-		if (!timer) {
-			timer = std::make_unique<QTimer>(/*timer?*/);
-			timer->setSingleShot(true);
-			connect(timer.get(), &QTimer::timeout, [this] { emit expired(); });
-		}
-
-		timer->setInterval(timeout);
-	} else {
-		timer.reset(nullptr);
+	timeout_ = timeout;
+	if (id) {
+		expirations->setTimeout(id, timeout);
+		if (expiration_)
+			expirations->resume(id);
 	}
 
 	emit timeoutChanged();
+	emit expirationChanged();
+	emit remainingFractionChanged();
+}
+
+double BzardExpirationController::remainingFraction() const {
+	return id ? expirations->remainingFraction(id) : 1.;
+}
+
+void BzardExpirationController::restart() {
+	if (id)
+		expirations->restart(id);
+	emit remainingFractionChanged();
 }
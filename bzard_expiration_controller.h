@@ -17,19 +17,33 @@
 
 #pragma once
 
-#include <memory>
-
 #include <QObject>
-#include <QTimer>
+#include <QQmlEngine>
+
+#include "bzard_expirations.h"
 
+/*
+ * A popup's handle on its countdown in BzardExpirations. Owns no timer;
+ * the expiration itself is handled in C++ together with the others that
+ * fall due in the same tick.
+ */
 class BzardExpirationController : public QObject {
 	Q_OBJECT
+	QML_ELEMENT
 
+	Q_PROPERTY(int notificationId READ notificationId WRITE setNotificationId
+	                 NOTIFY notificationIdChanged)
 	Q_PROPERTY(bool expiration READ expiration WRITE setExpiration NOTIFY
 	                 expirationChanged)
 	Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged)
+	Q_PROPERTY(double remainingFraction READ remainingFraction NOTIFY
+	                 remainingFractionChanged)
   public:
-	using QObject::QObject;
+	explicit BzardExpirationController(QObject *parent = nullptr);
+	~BzardExpirationController() override;
+
+	int notificationId() const;
+	void setNotificationId(int notificationId);
 
 	bool expiration() const;
 	void setExpiration(bool expiration);
@@ -37,13 +51,22 @@ class BzardExpirationController : public QObject {
 	int timeout() const;
 	void setTimeout(int timeout);
 
+	double remainingFraction() const;
+
   signals:
-	void expired();
+	void notificationIdChanged();
 	void expirationChanged();
 	void timeoutChanged();
+	void remainingFractionChanged();
 
   public slots:
+	// Counts the whole timeout again
+	void restart();
 
   private:
-	std::unique_ptr<QTimer> timer;
+	BzardExpirations *expirations;
+	BzardExpirations::IdT id{0};
+	int timeout_{0};
+	// Running unless paused, e.g. while hovered
+	bool expiration_{false};
 };
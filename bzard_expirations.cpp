@@ -0,0 +1,117 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_expirations.h"
+
+#include <QGuiApplication>
+#include <QScreen>
+
+BzardExpirations::BzardExpirations(QObject *parent)
+	  : QObject(parent), wheel{0} {
+	clock.start();
+	auto screen = QGuiApplication::primaryScreen();
+	auto refreshRate = screen ? screen->refreshRate() : 60.;
+	frameTimer.setTimerType(Qt::PreciseTimer);
+	frameTimer.setInterval(static_cast<int>(1000. / qMax(refreshRate, 1.)));
+	connect(&frameTimer, &QTimer::timeout, this, &BzardExpirations::tick);
+}
+
+void BzardExpirations::setTimeout(IdT id, int timeout) {
+	if (timeout <= 0) {
+		remove(id);
+		return;
+	}
+
+	auto found = countdowns.find(id);
+	if (found == countdowns.end()) {
+		countdowns.insert(id, {timeout, 0, timeout, false});
+		return;
+	}
+	found->timeout = timeout;
+	restart(id);
+}
+
+void BzardExpirations::pause(IdT id) {
+	auto found = countdowns.find(id);
+	if (found == countdowns.end() || !found->running)
+		return;
+	found->remaining = qMax(qint64{0}, found->deadline - clock.elapsed());
+	found->running = false;
+	wheel.cancel(id);
+	updateTimer();
+}
+
+void BzardExpirations::resume(IdT id) {
+	auto found = countdowns.find(id);
+	if (found == countdowns.end() || found->running)
+		return;
+	found->deadline = clock.elapsed() + found->remaining;
+	found->running = true;
+	wheel.schedule(id, found->deadline);
+	updateTimer();
+}
+
+void BzardExpirations::restart(IdT id) {
+	auto found = countdowns.find(id);
+	if (found == countdowns.end())
+		return;
+	found->remaining = found->timeout;
+	if (found->running) {
+		found->deadline = clock.elapsed() + found->timeout;
+		wheel.schedule(id, found->deadline);
+	}
+}
+
+void BzardExpirations::remove(IdT id) {
+	if (!countdowns.remove(id))
+		return;
+	wheel.cancel(id);
+	updateTimer();
+}
+
+bool BzardExpirations::isRunning(IdT id) const {
+	auto found = countdowns.constFind(id);
+	return found != countdowns.cend() && found->running;
+}
+
+double BzardExpirations::remainingFraction(IdT id) const {
+	auto found = countdowns.constFind(id);
+	if (found == countdowns.cend())
+		return 1.;
+	auto remaining = found->running ? found->deadline - clock.elapsed()
+	                                : found->remaining;
+	return qBound(0., static_cast<double>(remaining) / found->timeout, 1.);
+}
+
+void BzardExpirations::tick() {
+	QList<IdT> ids;
+	wheel.advance(clock.elapsed(), [&ids](IdT id) { ids.append(id); });
+	for (auto id : ids)
+		countdowns.remove(id);
+	updateTimer();
+
+	emit ticked();
+	if (!ids.isEmpty())
+		emit expired(ids);
+}
+
+void BzardExpirations::updateTimer() {
+	if (wheel.empty())
+		frameTimer.stop();
+	else if (!frameTimer.isActive())
+		frameTimer.start();
+}
@@ -0,0 +1,76 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+#include "bzard_notification.h"
+#include "bzard_timer_wheel.h"
+
+/*
+ * Expiration countdowns of all popups on one timer wheel and one frame
+ * timer, which runs only while some countdown is running. Countdowns
+ * start paused; pausing keeps the remaining time. Everything that expires
+ * within a tick is reported as one batch.
+ */
+class BzardExpirations : public QObject {
+	Q_OBJECT
+
+  public:
+	using IdT = BzardNotification::IdT;
+
+	explicit BzardExpirations(QObject *parent = nullptr);
+
+	// A timeout of 0 or less removes the countdown
+	void setTimeout(IdT id, int timeout);
+	void pause(IdT id);
+	void resume(IdT id);
+	// Counts the whole timeout again
+	void restart(IdT id);
+	void remove(IdT id);
+
+	bool isRunning(IdT id) const;
+	// Share of the timeout left, 1 without a countdown
+	double remainingFraction(IdT id) const;
+
+  signals:
+	void expired(const QList<BzardNotification::IdT> &IDS);
+	// Once per frame while any countdown is running
+	void ticked();
+
+  private:
+	struct Countdown {
+		qint64 timeout;
+		// Deadline while running, time left while paused
+		qint64 deadline;
+		qint64 remaining;
+		bool running;
+	};
+
+	QElapsedTimer clock;
+	BzardTimerWheel wheel;
+	QTimer frameTimer;
+	QHash<IdT, Countdown> countdowns;
+
+	void tick();
+	void updateTimer();
+};
@@ -0,0 +1,75 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_fenwick_tree.h"
+
+namespace {
+size_t lowbit(size_t index) { return index & (~index + 1); }
+} // namespace
+
+size_t BzardFenwickTree::size() const { return sums.size() - 1; }
+
+void BzardFenwickTree::clear() { sums.assign(1, 0); }
+
+void BzardFenwickTree::pushBack(int value) {
+	// A new node covers the tail of the values before it
+	auto index = sums.size();
+	auto covered = lowbit(index);
+	sums.push_back(value + prefix(index - 1) - prefix(index - covered));
+}
+
+void BzardFenwickTree::add(size_t index, int delta) {
+	for (++index; index < sums.size(); index += lowbit(index))
+		sums[index] += delta;
+}
+
+int BzardFenwickTree::prefix(size_t count) const {
+	int sum{0};
+	for (; count; count -= lowbit(count))
+		sum += sums[count];
+	return sum;
+}
+
+size_t BzardFenwickTree::lowerBound(int sum) const {
+	// The empty prefix already reaches it
+	if (sum <= 0)
+		return 0;
+
+	size_t step{1};
+	while (step * 2 <= size())
+		step *= 2;
+
+	// Walks down the implicit tree, skipping nodes that fall short
+	size_t count{0};
+	for (; step; step /= 2) {
+		if (count + step <= size() && sums[count + step] < sum) {
+			count += step;
+			sum -= sums[count];
+		}
+	}
+	return count + 1;
+}
+
+void BzardFenwickTree::assign(const std::vector<int> &values) {
+	sums.assign(values.size() + 1, 0);
+	for (size_t i = 1; i < sums.size(); ++i) {
+		sums[i] += values[i - 1];
+		auto parent = i + lowbit(i);
+		if (parent < sums.size())
+			sums[parent] += sums[i];
+	}
+}
@@ -0,0 +1,46 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/*
+ * Fenwick tree of ints: point updates, prefix sums and searches over them
+ * in O(log n).
+ */
+class BzardFenwickTree {
+  public:
+	size_t size() const;
+	void clear();
+	void pushBack(int value);
+	void add(size_t index, int delta);
+	// Sum of the first count values
+	int prefix(size_t count) const;
+	/*
+	 * Smallest count whose prefix reaches sum, size() + 1 if none does;
+	 * values must not be negative
+	 */
+	size_t lowerBound(int sum) const;
+	// Rebuilds from plain values in O(n)
+	void assign(const std::vector<int> &VALUES);
+
+  private:
+	// One-based, sums[i] covers (i - lowbit(i), i]
+	std::vector<int> sums{0};
+};
@@ -0,0 +1,125 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_grid.h"
+
+BzardGrid::BzardGrid(QScreen *screen, QObject *parent)
+	  : BzardDisposition(screen, parent) {
+	recalculateAvailableScreenGeometry();
+}
+
+BzardGrid::Optional<QPoint> BzardGrid::poses(BzardNotification::IdT id,
+                                             QSize size) {
+	// Already here, must be replaced
+	auto found = cellOf.constFind(id);
+	if (found != cellOf.cend())
+		return cellPosition(*found);
+
+	if (cellOf.isEmpty() && size != cell)
+		layout(size);
+
+	auto count = freeCells.lowerBound(1);
+	if (count > freeCells.size())
+		return {};
+	auto index = count - 1;
+	freeCells.add(index, -1);
+	cellOf.insert(id, index);
+	return cellPosition(index);
+}
+
+QPoint BzardGrid::externalWindowPosition() const {
+	// topRight() is one pixel left of the real edge, hence the - 1
+	return availableScreenGeometry.bottomRight() -
+	       QPoint{extraWindowSize.width() - 1, 0};
+}
+
+void BzardGrid::setExtraWindowSize(const QSize &value) {
+	BzardDisposition::setExtraWindowSize(value);
+	recalculateAvailableScreenGeometry();
+}
+
+void BzardGrid::setSpacing(int value) {
+	BzardDisposition::setSpacing(value);
+	recalculateAvailableScreenGeometry();
+}
+
+void BzardGrid::remove(BzardNotification::IdT id) {
+	auto found = cellOf.find(id);
+	if (found == cellOf.end())
+		return;
+
+	freeCells.add(*found, 1);
+	cellOf.erase(found);
+	// Nothing moves, but the freed cell is offered once per pass
+	scheduleReflow();
+}
+
+void BzardGrid::removeAll() {
+	freeCells.assign(std::vector<int>(freeCells.size(), 1));
+	cellOf.clear();
+	cancelReflow();
+}
+
+void BzardGrid::recalculateAvailableScreenGeometry() {
+	BzardDisposition::recalculateAvailableScreenGeometry();
+	auto extraBottomMargin = extraWindowSize.height() + spacing;
+	availableScreenGeometry -= QMargins{0, 0, 0, extraBottomMargin};
+	// Placed popups keep their cells
+	if (cellOf.isEmpty() && cell.isValid())
+		layout(cell);
+}
+
+void BzardGrid::reflow() {}
+
+// Popups keep their cell numbers; cells past the new grid are lost
+void BzardGrid::relayout() {
+	if (!cell.isValid())
+		return;
+
+	layout(cell);
+	for (auto placed = cellOf.begin(); placed != cellOf.end();) {
+		auto id = placed.key();
+		if (*placed >= freeCells.size()) {
+			placed = cellOf.erase(placed);
+			forgetMove(id);
+			emit overflowed(id);
+			continue;
+		}
+		freeCells.add(*placed, -1);
+		moveTo(id, cellPosition(*placed));
+		++placed;
+	}
+	scheduleReflow();
+}
+
+void BzardGrid::layout(QSize size) {
+	cell = size;
+	auto fit = [this](int available, int length) {
+		return qMax(0, (available + spacing) / qMax(1, length + spacing));
+	};
+	rows = fit(availableScreenGeometry.height(), cell.height());
+	auto columns = fit(availableScreenGeometry.width(), cell.width());
+	freeCells.assign(std::vector<int>(static_cast<size_t>(rows * columns), 1));
+}
+
+QPoint BzardGrid::cellPosition(size_t index) const {
+	auto column = static_cast<int>(index) / rows;
+	auto row = static_cast<int>(index) % rows;
+	return {availableScreenGeometry.right() + 1 -
+	              (column + 1) * cell.width() - column * spacing,
+	        availableScreenGeometry.top() + row * (cell.height() + spacing)};
+}
@@ -0,0 +1,65 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QPoint>
+
+#include "bzard_disposition.h"
+#include "bzard_fenwick_tree.h"
+
+/*
+ * Fixed cells of one popup size each, filled column by column from the
+ * top right. A popup takes the first free cell, found in O(log n) over a
+ * Fenwick tree of free cells, and never moves; freed cells are reused.
+ */
+class BzardGrid final : public BzardDisposition {
+	Q_OBJECT
+
+  public:
+	using BzardDisposition::Optional;
+
+	explicit BzardGrid(QScreen *screen = nullptr, QObject *parent = nullptr);
+
+	Optional<QPoint> poses(BzardNotification::IdT id, QSize size) final;
+
+	QPoint externalWindowPosition() const final;
+
+	void setExtraWindowSize(const QSize &value) final;
+
+	void setSpacing(int value) final;
+
+  public slots:
+	void remove(BzardNotification::IdT id) final;
+	void removeAll() final;
+
+  private:
+	// Popup size the cells were laid out for
+	QSize cell;
+	int rows{0};
+	// 1 for every free cell
+	BzardFenwickTree freeCells;
+	QHash<BzardNotification::IdT, size_t> cellOf;
+
+	void recalculateAvailableScreenGeometry() final;
+	void reflow() final;
+	void relayout() final;
+	void layout(QSize size);
+	QPoint cellPosition(size_t index) const;
+};
@@ -17,65 +17,657 @@
 
 #include "bzard_history.h"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+#include <fcntl.h>
+
+#include <QDBusMetaType>
 #include <QtQml/QtQml>
 
+#include <qt6xdg/XdgDirs>
+
+#include "bzard_history_export.h"
+#include "bzard_history_group_model.h"
+#include "bzard_history_search_model.h"
+
+namespace {
+QStringList search_texts(const BzardHistoryEntry &ENTRY) {
+	return {ENTRY.application, ENTRY.title, ENTRY.body};
+}
+} // namespace
+
 BzardHistory::BzardHistory()
 	  : BzardConfigurable{"history"},
+		maxEntries_{qMax(1u, config.value(CONFIG_MAX_ENTRIES,
+	                                      CONFIG_MAX_ENTRIES_DEFAULT)
+	                             .toUInt())},
+		maxBytes_{config.value(CONFIG_MAX_BYTES, CONFIG_MAX_BYTES_DEFAULT)
+	                    .toLongLong()},
+		replacedToTop{config.value(CONFIG_REPLACED_TO_TOP,
+	                               CONFIG_REPLACED_TO_TOP_DEFAULT)
+	                      .toBool()},
+		storage{maxEntries_, config.value(CONFIG_PACK_THRESHOLD,
+	                                      CONFIG_PACK_THRESHOLD_DEFAULT)
+	                               .toLongLong()},
 		model_{std::make_unique<BzardHistoryModel>(this)} {
-	qmlRegisterType<BzardHistoryNotification>("bzard", 1, 0,
-	                                          "HistoryNotification");
+	qRegisterMetaType<BzardHistoryEntry>();
+	qDBusRegisterMetaType<BzardHistoryEntry>();
+	qDBusRegisterMetaType<QList<BzardHistoryEntry>>();
+	insertTimer.setSingleShot(true);
+	insertTimer.setInterval(INSERT_BATCH_INTERVAL);
+	connect(&insertTimer, &QTimer::timeout, this,
+	        &BzardHistory::insertPending);
+	unreadableTimer.setSingleShot(true);
+	connect(&unreadableTimer, &QTimer::timeout, this,
+	        &BzardHistory::eraseUnreadable);
+	if (config.value(CONFIG_PERSISTENT, CONFIG_PERSISTENT_DEFAULT).toBool())
+		openLog();
+	searchModel_ = std::make_unique<BzardHistorySearchModel>(this);
+	groupModel_ = std::make_unique<BzardHistoryGroupModel>(this);
+}
+
+BzardHistory::~BzardHistory() = default;
+
+BzardHistory &BzardHistory::instance() {
+	static BzardHistory history;
+	return history;
+}
+
+BzardHistory *BzardHistory::create(QQmlEngine *engine,
+                                   QJSEngine *scriptEngine) {
+	Q_UNUSED(engine);
+	Q_UNUSED(scriptEngine);
+	// Static, the engine must not delete it
+	QJSEngine::setObjectOwnership(&instance(), QJSEngine::CppOwnership);
+	return &instance();
 }
 
 void BzardHistory::onCreateNotification(const BzardNotification &NOTIFICATION) {
-	historyList.push_front(
-		  std::make_unique<BzardHistoryNotification>(NOTIFICATION));
-	emit rowInserted();
+	// Clamped so that rows stay ordered by time even if the clock steps back
+	lastTimestamp = qMax(lastTimestamp, QDateTime::currentMSecsSinceEpoch());
+	BzardHistoryEntry entry{NOTIFICATION.id,    NOTIFICATION.application,
+	                        NOTIFICATION.title, NOTIFICATION.body,
+	                        NOTIFICATION.iconUrl, lastTimestamp};
+	if (NOTIFICATION.replacesId && replaceEntry(entry))
+		return;
+
+	auto slot = appendToLog(entry);
+	pendingById.insert(entry.id, pending.size());
+	pending.push_back({std::move(entry), slot});
+
+	// A burst becomes one model insert at the end of the frame
+	if (!insertTimer.isActive())
+		insertTimer.start();
 }
 
 void BzardHistory::onDropNotification(BzardNotification::IdT id) {
 	Q_UNUSED(id)
 }
 
+/*
+ * Updates the entry a replacement refers to, if it is still held. The row
+ * keeps its place and time, so only its data changes.
+ */
+bool BzardHistory::replaceEntry(BzardHistoryEntry entry) {
+	auto pendingAt = pendingById.constFind(entry.id);
+	if (pendingAt != pendingById.cend()) {
+		auto &replaced = pending[*pendingAt];
+		removeFromLog(replaced.slot);
+		replaced = {entry, appendToLog(entry)};
+		return true;
+	}
+
+	auto found = serialById.constFind(entry.id);
+	if (found == serialById.cend())
+		return false;
+	auto serial = *found;
+	auto row = storage.rowOfSerial(serial);
+	if (!row)
+		return false;
+
+	// Moving goes through removal and a regular insert
+	if (replacedToTop || storage.application(*row) != entry.application) {
+		model_->removeRowSet({*row});
+		return false;
+	}
+
+	unindexRow(*row);
+	removeFromLog(storage.logSlot(*row));
+	// The log keeps the new time, as the record is the newest there
+	auto slot = appendToLog(entry);
+	entry.timestamp = storage.timestamp(*row);
+	storage.replace(*row, entry, slot);
+	searchIndex.add(serial, search_texts(entry));
+	serialById.insert(entry.id, serial);
+
+	model_->updateRow(static_cast<int>(*row));
+	emit usedBytesChanged();
+	return true;
+}
+
+BzardHistoryLog::SlotT
+BzardHistory::appendToLog(const BzardHistoryEntry &ENTRY) {
+	// Never blocks: the log commits on its own thread
+	return log ? log->append(ENTRY) : BzardHistoryStorage::NO_SLOT;
+}
+
+template <class PredicateT>
+BzardHistory::RowsT BzardHistory::rowsWhere(PredicateT &&predicate) const {
+	// A full scan: readEntry() keeps it out of the decoded row cache
+	RowsT rows;
+	for (size_t i = 0; i < size(); ++i)
+		if (predicate(readEntry(i)))
+			rows.push_back(i);
+	return rows;
+}
+
+/*
+ * Visits the entries matching filter, newest first, skipping offset of
+ * them and stopping after limit.
+ */
+template <class VisitorT>
+void BzardHistory::forEachMatch(const QString &filter, size_t offset,
+                                size_t limit, VisitorT &&visitor) {
+	if (BzardHistoryIndex::isEmptyQuery(filter)) {
+		auto end = offset + qMin(limit, size() - qMin(offset, size()));
+		for (auto row = offset; row < end; ++row)
+			visitor(readEntry(row));
+		return;
+	}
+
+	auto serials = search(filter);
+	auto skip = qMin(offset, serials.size());
+	auto count = qMin(limit, serials.size() - skip);
+	auto first = serials.rbegin() + static_cast<std::ptrdiff_t>(skip);
+	auto last = first + static_cast<std::ptrdiff_t>(count);
+	for (auto it = first; it != last; ++it)
+		if (auto row = rowOfSerial(*it))
+			visitor(readEntry(*row));
+}
+
 void BzardHistory::remove(uint index) { model_->removeRow(index); }
 
+void BzardHistory::clear() {
+	insertPending();
+	model_->clearRows();
+}
+
+void BzardHistory::clearApplication(const QString &application) {
+	insertPending();
+	model_->removeRowSet(rowsWhere([&](const BzardHistoryEntry &ENTRY) {
+		return ENTRY.application == application;
+	}));
+}
+
+void BzardHistory::clearOlderThan(const QDateTime &time) {
+	insertPending();
+
+	// Older entries are exactly the rows below the cut
+	auto first = rowBefore(time.toMSecsSinceEpoch());
+	if (first == size())
+		return;
+	for (auto i = first; i < size(); ++i)
+		removeFromLog(logSlotAt(i));
+	model_->evictRows(static_cast<int>(size() - first));
+}
+
+void BzardHistory::removeIndexes(const QList<int> &indexes) {
+	RowsT rows;
+	rows.reserve(static_cast<size_t>(indexes.size()));
+	for (auto index : indexes)
+		if (index >= 0 && static_cast<size_t>(index) < size())
+			rows.push_back(static_cast<size_t>(index));
+	std::sort(rows.begin(), rows.end());
+	rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+	model_->removeRowSet(rows);
+}
+
+void BzardHistory::Clear() { clear(); }
+
+void BzardHistory::ClearApplication(const QString &application) {
+	clearApplication(application);
+}
+
+void BzardHistory::ClearOlderThan(qlonglong msecsSinceEpoch) {
+	clearOlderThan(QDateTime::fromMSecsSinceEpoch(msecsSinceEpoch));
+}
+
+void BzardHistory::RemoveIndexes(const QList<int> &indexes) {
+	removeIndexes(indexes);
+}
+
+uint BzardHistory::CountBetween(qlonglong fromMsecs, qlonglong toMsecs) {
+	// An empty or reversed range would wrap the unsigned difference
+	if (fromMsecs >= toMsecs)
+		return 0;
+	return static_cast<uint>(rowBefore(fromMsecs) - rowBefore(toMsecs));
+}
+
+uint BzardHistory::RowsBetween(qlonglong fromMsecs, qlonglong toMsecs,
+                               uint &count) {
+	auto first = rowBefore(toMsecs);
+	count = fromMsecs < toMsecs
+	              ? static_cast<uint>(rowBefore(fromMsecs) - first)
+	              : 0;
+	return static_cast<uint>(first);
+}
+
 QAbstractListModel *BzardHistory::model() const { return model_.get(); }
 
-void BzardHistory::removeHistoryNotification(uint index) {
-	auto it = historyList.begin();
-	std::advance(it, index);
-	historyList.erase(it);
+QAbstractItemModel *BzardHistory::searchModel() const {
+	return searchModel_.get();
 }
 
-BzardHistoryNotification::BzardHistoryNotification(
-	  const BzardNotification &NOTIFICATION, QObject *parent)
-	  : QObject(parent), ID__{NOTIFICATION.id},
-		APPLICATION{NOTIFICATION.application}, TITLE_{NOTIFICATION.title},
-		BODY_{NOTIFICATION.body}, ICON_URL_{NOTIFICATION.iconUrl} {}
+QAbstractItemModel *BzardHistory::groupModel() const {
+	// Grouping decodes every fetched row, so only once it is shown
+	groupModel_->populate();
+	return groupModel_.get();
+}
 
-uint BzardHistoryNotification::id_() const { return ID__; }
+int BzardHistory::maxEntries() const { return static_cast<int>(maxEntries_); }
 
-QString BzardHistoryNotification::application() const { return APPLICATION; }
+qint64 BzardHistory::maxBytes() const { return maxBytes_; }
 
-QString BzardHistoryNotification::title() const { return TITLE_; }
+qint64 BzardHistory::usedBytes() const {
+	return storage.byteCount() +
+	       static_cast<qint64>(restoredSlots.size() *
+	                           sizeof(BzardHistoryLog::SlotT));
+}
 
-QString BzardHistoryNotification::body() const { return BODY_; }
+double BzardHistory::bodyPackRatio() const { return storage.packRatio(); }
 
-QString BzardHistoryNotification::iconUrl() const { return ICON_URL_; }
+double BzardHistory::bodyUnpackMicroseconds() const {
+	return storage.averageUnpackMicroseconds();
+}
 
-BzardHistoryModel::BzardHistoryModel(BzardHistory::PtrT history)
-	  : bzardHistory{history} {
-	connect(bzardHistory, &BzardHistory::rowInserted, this,
-	        &BzardHistoryModel::onHistoryRowInserted);
+BzardHistoryEntry BzardHistory::entry(int index) const {
+	if (index < 0 || static_cast<size_t>(index) >= size())
+		return {};
+	auto row = static_cast<size_t>(index);
+	if (row < storage.size())
+		return storage.entry(row);
+	return restoredEntry(row - storage.size());
+}
+
+QList<BzardHistoryEntry> BzardHistory::GetHistory(uint offset, uint limit,
+                                                  const QString &filter) {
+	QList<BzardHistoryEntry> entries;
+	forEachMatch(filter, offset, limit, [&entries](BzardHistoryEntry entry) {
+		entries << std::move(entry);
+	});
+	return entries;
+}
+
+/*
+ * Matching entries are picked now, newest first, and written as the
+ * event loop allows; the return value is how many are to be written.
+ */
+uint BzardHistory::ExportJsonLines(const QDBusUnixFileDescriptor &file,
+                                   const QString &filter) {
+	// The caller opened the file, so it can only write where it may itself
+	auto fd = file.isValid()
+	                ? ::fcntl(file.fileDescriptor(), F_DUPFD_CLOEXEC, 0)
+	                : -1;
+	if (fd < 0) {
+		qWarning() << Q_FUNC_INFO << "No file descriptor to write to";
+		return 0;
+	}
+
+	std::vector<SerialT> serials;
+	if (BzardHistoryIndex::isEmptyQuery(filter)) {
+		serials.reserve(size());
+		for (size_t row = 0; row < size(); ++row)
+			serials.push_back(serialAt(row));
+	} else {
+		auto found = search(filter);
+		serials.assign(found.rbegin(), found.rend());
+	}
+	auto count = static_cast<uint>(serials.size());
+
+	// Rows shift as entries come and go, serials stay put
+	auto lookup = [this](SerialT serial) -> std::optional<BzardHistoryEntry> {
+		if (auto row = rowOfSerial(serial))
+			return readEntry(*row);
+		return {};
+	};
+	auto job = new BzardHistoryExport{fd, std::move(serials), lookup, this};
+	connect(job, &BzardHistoryExport::finished, this,
+	        [this, job](uint written) {
+		        emit ExportFinished(written);
+		        job->deleteLater();
+	        });
+	return count;
+}
+
+qlonglong BzardHistory::GetStatistics(double &packRatio,
+                                      double &unpackMicroseconds) {
+	packRatio = bodyPackRatio();
+	unpackMicroseconds = bodyUnpackMicroseconds();
+	return usedBytes();
+}
+
+int BzardHistory::rowAt(const QDateTime &time) const {
+	return static_cast<int>(rowBefore(time.toMSecsSinceEpoch() + 1));
+}
+
+int BzardHistory::countBetween(const QDateTime &from,
+                               const QDateTime &to) const {
+	if (from >= to)
+		return 0;
+	return static_cast<int>(rowBefore(from.toMSecsSinceEpoch()) -
+	                        rowBefore(to.toMSecsSinceEpoch()));
+}
+
+size_t BzardHistory::size() const {
+	return storage.size() + restoredSlots.size();
+}
+
+BzardHistoryEntry BzardHistory::restoredEntry(size_t index) const {
+	// Decoded from the mapped log on demand; recent rows stay decoded
+	auto slot = restoredSlots[index];
+	if (auto cached = decodedRows.object(slot))
+		return *cached;
+
+	auto entry = readRestored(index);
+	if (!entry)
+		return {};
+	decodedRows.insert(slot, new BzardHistoryEntry{*entry});
+	return *entry;
+}
+
+// Like entry(), but leaves the decoded row cache alone
+BzardHistoryEntry BzardHistory::readEntry(size_t index) const {
+	if (index < storage.size())
+		return storage.entry(index);
+	return readRestored(index - storage.size()).value_or(BzardHistoryEntry{});
+}
+
+/*
+ * Records are checked when first decoded, not on restore: an unreadable
+ * one is dropped once the current call is over.
+ */
+std::optional<BzardHistoryEntry>
+BzardHistory::readRestored(size_t index) const {
+	auto slot = restoredSlots[index];
+	auto entry = log->read(slot);
+	if (!entry) {
+		unreadableSlots.push_back(slot);
+		unreadableTimer.start();
+	}
+	return entry;
+}
+
+void BzardHistory::eraseUnreadable() {
+	RowsT rows;
+	for (auto slot : unreadableSlots)
+		if (auto row = rowOfSerial(slot); row && *row >= storage.size())
+			rows.push_back(*row);
+	unreadableSlots.clear();
+	if (rows.empty())
+		return;
+
+	std::sort(rows.begin(), rows.end());
+	rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+	model_->removeRowSet(rows);
+}
+
+BzardHistoryLog::SlotT BzardHistory::logSlotAt(size_t index) const {
+	if (index < storage.size())
+		return storage.logSlot(index);
+	return restoredSlots[index - storage.size()];
+}
+
+qint64 BzardHistory::timestampAt(size_t index) const {
+	if (index < storage.size())
+		return storage.timestamp(index);
+
+	// Probes would push the rows on screen out of decodedRows, so they
+	// are read straight from the log. An unreadable row, dropped soon,
+	// takes the time of the next readable one to keep the order.
+	for (auto i = index - storage.size(); i < restoredSlots.size(); ++i)
+		if (auto entry = readRestored(i))
+			return entry->timestamp;
+	return 0;
+}
+
+/*
+ * First row received before msecs. Timestamps never grow down the rows,
+ * so this is a binary search; restored rows are decoded per probe only.
+ */
+size_t BzardHistory::rowBefore(qint64 msecs) const {
+	size_t first{0}, last{size()};
+	while (first < last) {
+		auto middle = first + (last - first) / 2;
+		if (timestampAt(middle) >= msecs)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return first;
+}
+
+BzardHistory::SerialT BzardHistory::serialAt(size_t index) const {
+	if (index < storage.size())
+		return storage.serial(index);
+	return restoredSlots[index - storage.size()];
+}
+
+std::optional<size_t> BzardHistory::rowOfSerial(SerialT serial) const {
+	// Received serials are all above the restored ones
+	if (!storage.empty() && serial >= storage.serial(storage.size() - 1))
+		return storage.rowOfSerial(serial);
+
+	auto found = std::lower_bound(restoredSlots.cbegin(), restoredSlots.cend(),
+	                              serial, std::greater<>{});
+	if (found == restoredSlots.cend() || *found != serial)
+		return {};
+	return storage.size() +
+	       static_cast<size_t>(std::distance(restoredSlots.cbegin(), found));
+}
+
+std::vector<BzardHistory::SerialT> BzardHistory::search(const QString &query) {
+	if (!restoredIndexed) {
+		// Oldest first, so postings are appended to rather than shifted
+		for (auto i = restoredSlots.size(); i-- > 0;)
+			searchIndex.add(
+			    restoredSlots[i],
+			    search_texts(readRestored(i).value_or(BzardHistoryEntry{})));
+		restoredIndexed = true;
+	}
+	return searchIndex.search(query);
+}
+
+bool BzardHistory::rowMatches(size_t index, const QString &query) const {
+	auto row = entry(static_cast<int>(index));
+	return BzardHistoryIndex::matches(query, search_texts(row));
+}
+
+// Forgets a row in the id map and the search index
+void BzardHistory::unindexRow(size_t index) {
+	if (index < storage.size()) {
+		auto found = serialById.find(storage.id(index));
+		if (found != serialById.end() && *found == storage.serial(index))
+			serialById.erase(found);
+	} else if (!restoredIndexed) {
+		return;
+	}
+	auto row = entry(static_cast<int>(index));
+	searchIndex.remove(serialAt(index), search_texts(row));
+}
+
+qint64 BzardHistory::rowBytes(size_t index) const {
+	if (index < storage.size())
+		return storage.rowBytes(index);
+	return sizeof(BzardHistoryLog::SlotT);
+}
+
+void BzardHistory::insertPending() {
+	insertTimer.stop();
+	if (pending.empty())
+		return;
+
+	// Older entries of a huge burst would be evicted at once anyway
+	if (pending.size() > maxEntries_)
+		pending.erase(pending.begin(),
+		              pending.end() - static_cast<std::ptrdiff_t>(maxEntries_));
+
+	qint64 bytes{0};
+	for (const auto &PENDING : pending)
+		bytes += BzardHistoryStorage::estimateBytes(PENDING.entry);
+	makeRoom(pending.size(), bytes);
+	model_->insertPendingRows(static_cast<int>(pending.size()));
+}
+
+void BzardHistory::pushPending() {
+	for (const auto &PENDING : pending) {
+		auto serial = nextSerial++;
+		storage.pushFront(PENDING.entry, serial, PENDING.slot);
+		searchIndex.add(serial, search_texts(PENDING.entry));
+		serialById.insert(PENDING.entry.id, serial);
+	}
+	pending.clear();
+	pendingById.clear();
+	emit usedBytesChanged();
+}
+
+/*
+ * Evicts the oldest rows until incomingRows more rows of incomingBytes fit
+ * both caps. Evicted entries are flagged removed in the on-disk log too,
+ * so compaction reclaims them.
+ */
+void BzardHistory::makeRoom(size_t incomingRows, qint64 incomingBytes) {
+	auto rows = size();
+	auto bytes = usedBytes() + incomingBytes;
+	size_t evict{0};
+	while (evict < rows &&
+	       (rows - evict + incomingRows > maxEntries_ || bytes > maxBytes_)) {
+		bytes -= rowBytes(rows - evict - 1);
+		++evict;
+	}
+	if (evict)
+		model_->evictRows(static_cast<int>(evict));
+}
+
+void BzardHistory::dropOldest(size_t count) {
+	for (auto i = size() - count; i < size(); ++i) {
+		unindexRow(i);
+		removeFromLog(logSlotAt(i));
+		if (i >= storage.size())
+			decodedRows.remove(logSlotAt(i));
+	}
+
+	// Restored entries are always older than the received ones
+	auto restored = qMin(count, restoredSlots.size());
+	restoredSlots.resize(restoredSlots.size() - restored);
+	storage.popBack(count - restored);
+	emit usedBytesChanged();
+}
+
+/*
+ * Removes rows given ascending and unique in one pass over each column.
+ * The caller emits the model signals.
+ */
+void BzardHistory::eraseRows(const RowsT &rows) {
+	RowsT received, restored;
+	for (auto row : rows) {
+		unindexRow(row);
+		removeFromLog(logSlotAt(row));
+		if (row < storage.size())
+			received.push_back(row);
+		else
+			restored.push_back(row - storage.size());
+		decodedRows.remove(logSlotAt(row));
+	}
+	storage.erase(received);
+
+	size_t kept{0};
+	auto next = restored.cbegin();
+	for (size_t i = 0; i < restoredSlots.size(); ++i) {
+		if (next != restored.cend() && *next == i) {
+			++next;
+			continue;
+		}
+		restoredSlots[kept++] = restoredSlots[i];
+	}
+	restoredSlots.resize(kept);
+	emit usedBytesChanged();
+}
+
+void BzardHistory::eraseAll() {
+	for (size_t i = 0; i < storage.size(); ++i)
+		removeFromLog(storage.logSlot(i));
+	for (auto slot : restoredSlots)
+		removeFromLog(slot);
+	searchIndex.clear();
+	serialById.clear();
+	decodedRows.clear();
+	storage.clear();
+	restoredSlots.clear();
+	emit usedBytesChanged();
+}
+
+void BzardHistory::removeFromLog(BzardHistoryLog::SlotT slot) {
+	if (log && slot != BzardHistoryStorage::NO_SLOT)
+		log->remove(slot);
+}
+
+void BzardHistory::openLog() {
+	auto directory =
+		  XdgDirs::dataHome() + '/' + BzardConfig::applicationName();
+	log = std::make_unique<BzardHistoryLog>(directory);
+	if (!log->open()) {
+		qWarning() << Q_FUNC_INFO << "History will not be persistent";
+		log.reset();
+		return;
+	}
+
+	// Only slot numbers here, records stay in the mapped file
+	auto slots = log->liveSlots();
+	auto keep = qMin(slots.size(), maxEntries_);
+	restoredSlots.assign(slots.rbegin(), slots.rbegin() + keep);
+	// Past max_entries, e.g. after it was lowered: evicted like any other
+	for (auto it = slots.rbegin() + keep; it != slots.rend(); ++it)
+		log->remove(*it);
+	if (!restoredSlots.empty()) {
+		nextSerial = restoredSlots.front() + 1;
+		lastTimestamp = timestampAt(storage.size());
+	}
 }
 
+BzardHistoryModel::BzardHistoryModel(BzardHistory::PtrT history)
+	  : bzardHistory{history} {}
+
 int BzardHistoryModel::rowCount(const QModelIndex &parent) const {
 	if (!bzardHistory)
 		return 0;
 
-	return bzardHistory->historyList.size();
+	return static_cast<int>(bzardHistory->storage.size() + fetched);
 	Q_UNUSED(parent);
 }
 
+bool BzardHistoryModel::canFetchMore(const QModelIndex &parent) const {
+	if (!bzardHistory || parent.isValid())
+		return false;
+	return fetched < bzardHistory->restoredSlots.size();
+}
+
+/*
+ * Received entries are resident anyway; restored ones are exposed a page
+ * at a time as the view scrolls down.
+ */
+void BzardHistoryModel::fetchMore(const QModelIndex &parent) {
+	if (!canFetchMore(parent))
+		return;
+
+	auto first = rowCount({});
+	auto count = qMin(FETCH_PAGE, bzardHistory->restoredSlots.size() - fetched);
+	beginInsertRows({}, first, first + static_cast<int>(count) - 1);
+	fetched += count;
+	endInsertRows();
+}
+
 QVariant BzardHistoryModel::data(const QModelIndex &index, int role) const {
 	if (!bzardHistory)
 		return {};
@@ -83,22 +675,54 @@ QVariant BzardHistoryModel::data(const QModelIndex &index, int role) const {
 	if (!index.isValid())
 		return QVariant();
 
-	auto &index_ = bzardHistory->historyList[index.row()];
+	// Received entries are read from the columns in place
+	const auto &STORAGE = bzardHistory->storage;
+	auto row = static_cast<size_t>(index.row());
+	if (row < STORAGE.size()) {
+		switch (role) {
+		case HR_ID_ROLE:
+			return STORAGE.id(row);
+			break;
+		case HR_APPLICATION_ROLE:
+			return STORAGE.application(row);
+			break;
+		case HR_TITLE_ROLE:
+			return STORAGE.title(row);
+			break;
+		case HR_BODY_ROLE:
+			return STORAGE.body(row);
+			break;
+		case HR_ICON_URL_ROLE:
+			return STORAGE.iconUrl(row);
+			break;
+		case HR_TIMESTAMP_ROLE:
+			return QDateTime::fromMSecsSinceEpoch(STORAGE.timestamp(row));
+			break;
+		default:
+			break;
+		}
+		return {};
+	}
+
+	auto index_ = bzardHistory->restoredEntry(row - STORAGE.size());
 	switch (role) {
 	case HR_ID_ROLE:
-		return index_->id_();
+		return index_.id;
 		break;
 	case HR_APPLICATION_ROLE:
-		return index_->application();
+		return index_.application;
 		break;
 	case HR_TITLE_ROLE:
-		return index_->title();
+		return index_.title;
 		break;
 	case HR_BODY_ROLE:
-		return index_->body();
+		return index_.body;
 		break;
 	case HR_ICON_URL_ROLE:
-		return index_->iconUrl();
+		return index_.iconUrl;
+		break;
+	case HR_TIMESTAMP_ROLE:
+		return QDateTime::fromMSecsSinceEpoch(index_.timestamp);
 		break;
 	default:
 		break;
@@ -106,35 +730,23 @@ QVariant BzardHistoryModel::data(const QModelIndex &index, int role) const {
 	return {};
 }
 
-bool BzardHistoryModel::insertRows(int row, int count,
-                                   const QModelIndex &parent) {
-	if (row || count > 1)
-		return false;
-
-	beginInsertRows(parent, 0, 0);
-	endInsertRows();
-	return true;
-}
-
 bool BzardHistoryModel::removeRows(int row, int count,
                                    const QModelIndex &parent) {
 	if (!bzardHistory)
 		return false;
 
-	auto &list = bzardHistory->historyList;
-	if (static_cast<size_t>(row) >= list.size() || row + count <= 0)
+	auto size = static_cast<size_t>(rowCount({}));
+	if (static_cast<size_t>(row) >= size || row + count <= 0)
 		return false;
 
 	auto beginRow = qMax(0, row);
-	auto endRow = qMin(row + count - 1, static_cast<int>(list.size() - 1));
+	auto endRow = qMin(row + count - 1, static_cast<int>(size - 1));
 
-	beginRemoveRows(parent, beginRow, endRow);
-
-	while (beginRow <= endRow) {
-		bzardHistory->removeHistoryNotification(beginRow);
-		++beginRow;
-	}
+	BzardHistory::RowsT rows(static_cast<size_t>(endRow - beginRow + 1));
+	std::iota(rows.begin(), rows.end(), static_cast<size_t>(beginRow));
 
+	beginRemoveRows(parent, beginRow, endRow);
+	eraseRows(rows);
 	endRemoveRows();
 	return true;
 }
@@ -146,7 +758,83 @@ QHash<int, QByteArray> BzardHistoryModel::roleNames() const {
 	roles[HR_TITLE_ROLE] = "title";
 	roles[HR_BODY_ROLE] = "body";
 	roles[HR_ICON_URL_ROLE] = "iconUrl";
+	roles[HR_TIMESTAMP_ROLE] = "timestamp";
 	return roles;
 }
 
-void BzardHistoryModel::onHistoryRowInserted() { insertRow(0); }
+void BzardHistoryModel::insertPendingRows(int count) {
+	beginInsertRows({}, 0, count - 1);
+	bzardHistory->pushPending();
+	endInsertRows();
+}
+
+/*
+ * One signal per bulk operation: a contiguous run is a plain removal,
+ * anything else resets the view instead of removing row by row.
+ */
+void BzardHistoryModel::removeRowSet(const BzardHistory::RowsT &rows) {
+	// Rows not fetched yet leave the view alone
+	auto shown = static_cast<size_t>(rowCount({}));
+	auto end = std::lower_bound(rows.cbegin(), rows.cend(), shown);
+	if (end == rows.cbegin()) {
+		eraseRows(rows);
+		return;
+	}
+
+	auto first = rows.front();
+	auto last = *std::prev(end);
+	if (last - first + 1 == static_cast<size_t>(end - rows.cbegin())) {
+		beginRemoveRows({}, static_cast<int>(first), static_cast<int>(last));
+		eraseRows(rows);
+		endRemoveRows();
+		return;
+	}
+
+	beginResetModel();
+	eraseRows(rows);
+	endResetModel();
+}
+
+void BzardHistoryModel::clearRows() {
+	beginResetModel();
+	bzardHistory->eraseAll();
+	fetched = 0;
+	endResetModel();
+}
+
+void BzardHistoryModel::updateRow(int row) {
+	auto changed = index(row);
+	emit dataChanged(changed, changed);
+}
+
+void BzardHistoryModel::evictRows(int count) {
+	// Eviction takes restored rows first, unfetched ones before fetched
+	const auto &RESTORED = bzardHistory->restoredSlots;
+	auto evicted = static_cast<size_t>(count);
+	auto restoredLeft = RESTORED.size() - qMin(evicted, RESTORED.size());
+	auto receivedLeft = bzardHistory->storage.size() -
+	                    (evicted - (RESTORED.size() - restoredLeft));
+	auto fetchedLeft = qMin(fetched, restoredLeft);
+
+	auto shown = rowCount({});
+	auto shownLeft = static_cast<int>(receivedLeft + fetchedLeft);
+	if (shownLeft == shown) {
+		bzardHistory->dropOldest(evicted);
+		return;
+	}
+
+	beginRemoveRows({}, shownLeft, shown - 1);
+	bzardHistory->dropOldest(evicted);
+	fetched = fetchedLeft;
+	endRemoveRows();
+}
+
+void BzardHistoryModel::eraseRows(const BzardHistory::RowsT &rows) {
+	auto receivedCount = bzardHistory->storage.size();
+	auto fetchedEnd = receivedCount + fetched;
+	fetched -= static_cast<size_t>(std::count_if(
+		  rows.cbegin(), rows.cend(), [&](auto row) {
+			  return row >= receivedCount && row < fetchedEnd;
+		  }));
+	bzardHistory->eraseRows(rows);
+}
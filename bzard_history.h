@@ -17,52 +17,82 @@
 
 #pragma once
 
-#include <deque>
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include <QAbstractListModel>
+#include <QCache>
+#include <QDBusUnixFileDescriptor>
+#include <QDateTime>
+#include <QList>
 #include <QObject>
+#include <QQmlEngine>
+#include <QTimer>
 
 #include "bzard_config.h"
+#include "bzard_history_entry.h"
+#include "bzard_history_index.h"
+#include "bzard_history_log.h"
+#include "bzard_history_storage.h"
 #include "bzard_notification_receiver.h"
+class BzardHistoryGroupModel;
 class BzardHistoryModel;
-
-class BzardHistoryNotification : public QObject {
-	Q_OBJECT
-	Q_PROPERTY(uint id_ READ id_ CONSTANT)
-	Q_PROPERTY(QString application READ application CONSTANT)
-	Q_PROPERTY(QString title READ title CONSTANT)
-	Q_PROPERTY(QString body READ body CONSTANT)
-	Q_PROPERTY(QString iconUrl READ iconUrl CONSTANT)
-  public:
-	BzardHistoryNotification() = default;
-	BzardHistoryNotification(const BzardNotification &notification,
-	                         QObject *parent = nullptr);
-
-	uint id_() const;
-	QString application() const;
-	QString title() const;
-	QString body() const;
-	QString iconUrl() const;
-
-  private:
-	const uint ID__{0};
-	const QString APPLICATION;
-	const QString TITLE_;
-	const QString BODY_;
-	const QString ICON_URL_;
-};
+class BzardHistorySearchModel;
 
 class BzardHistory : public BzardNotificationReceiver,
 					 public BzardConfigurable {
+	friend class BzardHistoryGroupModel;
 	friend class BzardHistoryModel;
+	friend class BzardHistorySearchModel;
 
 	Q_OBJECT
+	QML_ELEMENT
+	QML_SINGLETON
 	Q_PROPERTY(bool isEnabled READ isEnabled CONSTANT)
 	Q_PROPERTY(QAbstractItemModel *model READ model CONSTANT)
+	Q_PROPERTY(QAbstractItemModel *searchModel READ searchModel CONSTANT)
+	Q_PROPERTY(QAbstractItemModel *groupModel READ groupModel CONSTANT)
+	Q_PROPERTY(int maxEntries READ maxEntries CONSTANT)
+	Q_PROPERTY(qint64 maxBytes READ maxBytes CONSTANT)
+	Q_PROPERTY(qint64 usedBytes READ usedBytes NOTIFY usedBytesChanged)
+	Q_PROPERTY(double bodyPackRatio READ bodyPackRatio NOTIFY usedBytesChanged)
+	Q_PROPERTY(double bodyUnpackMicroseconds READ bodyUnpackMicroseconds NOTIFY
+	                 usedBytesChanged)
   public:
 	BzardHistory();
+	~BzardHistory() override;
+	static BzardHistory &instance();
+	static BzardHistory *create(QQmlEngine *engine, QJSEngine *scriptEngine);
 	QAbstractListModel *model() const;
+	QAbstractItemModel *searchModel() const;
+	QAbstractItemModel *groupModel() const;
+
+	int maxEntries() const;
+	qint64 maxBytes() const;
+	qint64 usedBytes() const;
+	double bodyPackRatio() const;
+	double bodyUnpackMicroseconds() const;
+
+	Q_INVOKABLE BzardHistoryEntry entry(int index) const;
+	// First row received at or before time
+	Q_INVOKABLE int rowAt(const QDateTime &TIME) const;
+	// Entries received in [from, to)
+	Q_INVOKABLE int countBetween(const QDateTime &FROM,
+	                             const QDateTime &TO) const;
+
+	// DBus interface
+	void Clear();
+	void ClearApplication(const QString &application);
+	void ClearOlderThan(qlonglong msecsSinceEpoch);
+	void RemoveIndexes(const QList<int> &indexes);
+	uint CountBetween(qlonglong fromMsecs, qlonglong toMsecs);
+	uint RowsBetween(qlonglong fromMsecs, qlonglong toMsecs, uint &count);
+	QList<BzardHistoryEntry> GetHistory(uint offset, uint limit,
+	                                    const QString &filter);
+	uint ExportJsonLines(const QDBusUnixFileDescriptor &file,
+	                     const QString &filter);
+	qlonglong GetStatistics(double &packRatio, double &unpackMicroseconds);
 
   public slots:
 	/*
@@ -75,19 +105,104 @@ class BzardHistory : public BzardNotificationReceiver,
 	 * QML slots
 	 */
 	void remove(uint index);
+	void clear();
+	void clearApplication(const QString &APPLICATION);
+	void clearOlderThan(const QDateTime &TIME);
+	void removeIndexes(const QList<int> &INDEXES);
 
   signals:
-	void rowInserted();
+	void usedBytesChanged();
+	// DBus, once per export started with ExportJsonLines
+	void ExportFinished(uint count);
 
   private:
+	BZARD_CONFIG_VAR(PERSISTENT, "persistent", false)
+	BZARD_CONFIG_VAR(MAX_ENTRIES, "max_entries", 10000)
+	BZARD_CONFIG_VAR(MAX_BYTES, "max_bytes", 16 * 1024 * 1024)
+	BZARD_CONFIG_VAR(PACK_THRESHOLD, "pack_threshold", 1024)
+	BZARD_CONFIG_VAR(REPLACED_TO_TOP, "replaced_to_top", false)
+
 	using PtrT = BzardHistory *;
-	std::deque<std::unique_ptr<BzardHistoryNotification>> historyList;
-	std::unique_ptr<BzardHistoryModel> model_;
+	using SerialT = BzardHistoryStorage::SerialT;
+	// Row numbers, ascending
+	using RowsT = std::vector<size_t>;
+
+	// Received but not yet in the model
+	struct PendingEntry {
+		BzardHistoryEntry entry;
+		BzardHistoryLog::SlotT slot;
+	};
 
-	void removeHistoryNotification(uint index);
+	// One frame at 60 Hz
+	static constexpr auto INSERT_BATCH_INTERVAL = 16;
+	// A few screens of restored rows
+	static constexpr auto DECODED_ROWS = 256;
+
+	const size_t maxEntries_;
+	const qint64 maxBytes_;
+	const bool replacedToTop;
+	// Notifications received since start, newest first
+	BzardHistoryStorage storage;
+	// Entries restored from the log, newest first; shown after storage
+	std::vector<BzardHistoryLog::SlotT> restoredSlots;
+	std::unique_ptr<BzardHistoryLog> log;
+	// Least recently shown restored rows are dropped first
+	mutable QCache<BzardHistoryLog::SlotT, BzardHistoryEntry> decodedRows{
+		  DECODED_ROWS};
+	// Oldest first
+	std::vector<PendingEntry> pending;
+	QHash<uint, size_t> pendingById;
+	// Received entries by notification id, for replacements
+	QHash<uint, SerialT> serialById;
+	QTimer insertTimer;
+	// Restored slots found unreadable, dropped on the next pass
+	mutable std::vector<BzardHistoryLog::SlotT> unreadableSlots;
+	mutable QTimer unreadableTimer;
+	qint64 lastTimestamp{0};
+	// Restored entries use their log slot as serial, so received ones
+	// start above the newest restored slot
+	SerialT nextSerial{0};
+	BzardHistoryIndex searchIndex;
+	// Restored entries are indexed on the first search only
+	bool restoredIndexed{false};
+	std::unique_ptr<BzardHistoryModel> model_;
+	std::unique_ptr<BzardHistorySearchModel> searchModel_;
+	std::unique_ptr<BzardHistoryGroupModel> groupModel_;
+
+	size_t size() const;
+	bool replaceEntry(BzardHistoryEntry entry);
+	BzardHistoryLog::SlotT appendToLog(const BzardHistoryEntry &ENTRY);
+	BzardHistoryEntry restoredEntry(size_t index) const;
+	std::optional<BzardHistoryEntry> readRestored(size_t index) const;
+	void eraseUnreadable();
+	BzardHistoryLog::SlotT logSlotAt(size_t index) const;
+	qint64 timestampAt(size_t index) const;
+	size_t rowBefore(qint64 msecs) const;
+	SerialT serialAt(size_t index) const;
+	std::optional<size_t> rowOfSerial(SerialT serial) const;
+	std::vector<SerialT> search(const QString &QUERY);
+	bool rowMatches(size_t index, const QString &QUERY) const;
+	void unindexRow(size_t index);
+	qint64 rowBytes(size_t index) const;
+	void insertPending();
+	void pushPending();
+	void makeRoom(size_t incomingRows, qint64 incomingBytes);
+	void dropOldest(size_t count);
+	void eraseRows(const RowsT &ROWS);
+	void eraseAll();
+	void removeFromLog(BzardHistoryLog::SlotT slot);
+	template <class PredicateT>
+	RowsT rowsWhere(PredicateT &&predicate) const;
+	BzardHistoryEntry readEntry(size_t index) const;
+	template <class VisitorT>
+	void forEachMatch(const QString &FILTER, size_t offset, size_t limit,
+	                  VisitorT &&visitor);
+	void openLog();
 };
 
 class BzardHistoryModel : public QAbstractListModel {
+	friend class BzardHistory;
+
 	Q_OBJECT
   public:
 	enum HistoryRoles {
@@ -95,18 +210,28 @@ class BzardHistoryModel : public QAbstractListModel {
 		HR_APPLICATION_ROLE,
 		HR_TITLE_ROLE,
 		HR_BODY_ROLE,
-		HR_ICON_URL_ROLE
+		HR_ICON_URL_ROLE,
+		HR_TIMESTAMP_ROLE
 	};
 	explicit BzardHistoryModel(BzardHistory::PtrT history_);
 	int rowCount(const QModelIndex &parent) const final;
 	QVariant data(const QModelIndex &index, int role) const final;
-	bool insertRows(int row, int count, const QModelIndex &parent) final;
+	bool canFetchMore(const QModelIndex &parent) const final;
+	void fetchMore(const QModelIndex &parent) final;
 	bool removeRows(int row, int count, const QModelIndex &parent) final;
 	QHash<int, QByteArray> roleNames() const final;
 
-  private slots:
-	void onHistoryRowInserted();
-
   private:
+	static constexpr size_t FETCH_PAGE = 100;
+
 	BzardHistory *bzardHistory;
+	// Restored rows shown so far; received rows are always shown
+	size_t fetched{0};
+
+	void insertPendingRows(int count);
+	void removeRowSet(const BzardHistory::RowsT &ROWS);
+	void clearRows();
+	void updateRow(int row);
+	void evictRows(int count);
+	void eraseRows(const BzardHistory::RowsT &ROWS);
 };
@@ -0,0 +1,45 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_history_entry.h"
+
+QJsonObject BzardHistoryEntry::toJson() const {
+	return {{"id", static_cast<qint64>(id)},
+	        {"application", application},
+	        {"title", title},
+	        {"body", body},
+	        {"iconUrl", iconUrl},
+	        {"timestamp", timestamp}};
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument,
+                          const BzardHistoryEntry &entry) {
+	argument.beginStructure();
+	argument << entry.id << entry.application << entry.title << entry.body
+	         << entry.iconUrl << entry.timestamp;
+	argument.endStructure();
+	return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument,
+                                BzardHistoryEntry &entry) {
+	argument.beginStructure();
+	argument >> entry.id >> entry.application >> entry.title >> entry.body >>
+		  entry.iconUrl >> entry.timestamp;
+	argument.endStructure();
+	return argument;
+}
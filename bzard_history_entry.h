@@ -0,0 +1,55 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QDBusArgument>
+#include <QJsonObject>
+#include <QMetaType>
+#include <QString>
+
+/*
+ * Plain value describing one history entry. Handed to QML and D-Bus by
+ * value; storage keeps entries in columns, not as objects.
+ */
+struct BzardHistoryEntry {
+	Q_GADGET
+	Q_PROPERTY(uint id_ MEMBER id)
+	Q_PROPERTY(QString application MEMBER application)
+	Q_PROPERTY(QString title MEMBER title)
+	Q_PROPERTY(QString body MEMBER body)
+	Q_PROPERTY(QString iconUrl MEMBER iconUrl)
+	Q_PROPERTY(qint64 timestamp MEMBER timestamp)
+  public:
+	uint id{0};
+	QString application;
+	QString title;
+	QString body;
+	QString iconUrl;
+	// Milliseconds since the epoch when the entry was received
+	qint64 timestamp{0};
+
+	QJsonObject toJson() const;
+};
+
+// D-Bus signature (ussssx)
+QDBusArgument &operator<<(QDBusArgument &argument,
+                          const BzardHistoryEntry &ENTRY);
+const QDBusArgument &operator>>(const QDBusArgument &argument,
+                                BzardHistoryEntry &entry);
+
+Q_DECLARE_METATYPE(BzardHistoryEntry)
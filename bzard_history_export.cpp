@@ -0,0 +1,156 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_history_export.h"
+
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstring>
+
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <QDebug>
+#include <QJsonDocument>
+
+namespace {
+// Bounds a blocking write, so a stalled reader never holds up shutdown
+constexpr int POLL_INTERVAL_MS = 100;
+} // namespace
+
+BzardHistoryExport::BzardHistoryExport(int fd, std::vector<SerialT> serials,
+                                       LookupT lookup, QObject *parent)
+    : QObject{parent},
+      fd{fd},
+      serials{std::move(serials)},
+      lookup{std::move(lookup)} {
+	connect(&pump, &QTimer::timeout, this, &BzardHistoryExport::encodeChunk);
+	pump.start(0);
+	writer = std::jthread{[this](std::stop_token stop) { writeLoop(stop); }};
+}
+
+BzardHistoryExport::~BzardHistoryExport() {
+	// Unwritten chunks are dropped: the caller only waits for finished()
+	writer.request_stop();
+	writer.join();
+	::close(fd);
+}
+
+void BzardHistoryExport::encodeChunk() {
+	{
+		std::lock_guard lock{mutex};
+		if (failed) {
+			pump.stop();
+			return;
+		}
+		if (queuedBytes > MAX_QUEUED_BYTES) {
+			pump.setInterval(BACKLOG_INTERVAL_MS);
+			return;
+		}
+	}
+	pump.setInterval(0);
+
+	QByteArray chunk;
+	auto end = qMin(next + CHUNK_ENTRIES, serials.size());
+	for (; next < end; ++next) {
+		auto entry = lookup(serials[next]);
+		if (!entry)
+			continue;
+		chunk += QJsonDocument{entry->toJson()}.toJson(QJsonDocument::Compact);
+		chunk += '\n';
+		++count;
+	}
+
+	{
+		std::lock_guard lock{mutex};
+		if (!chunk.isEmpty()) {
+			queuedBytes += chunk.size();
+			chunks.push_back(std::move(chunk));
+		}
+		if (next == serials.size()) {
+			done = true;
+			pump.stop();
+		}
+	}
+	wakeUp.notify_one();
+}
+
+void BzardHistoryExport::writeLoop(std::stop_token stop) {
+	// A reader gone away is a failed export, not a reason to exit
+	sigset_t blocked;
+	sigemptyset(&blocked);
+	sigaddset(&blocked, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &blocked, nullptr);
+
+	while (true) {
+		QByteArray chunk;
+		{
+			std::unique_lock lock{mutex};
+			wakeUp.wait(lock, stop, [this] { return !chunks.empty() || done; });
+			if (chunks.empty())
+				break;
+			chunk = std::move(chunks.front());
+			chunks.pop_front();
+		}
+		if (!writeAll(stop, chunk)) {
+			std::lock_guard lock{mutex};
+			failed = true;
+			chunks.clear();
+			break;
+		}
+		std::lock_guard lock{mutex};
+		queuedBytes -= chunk.size();
+	}
+	if (stop.stop_requested())
+		return;
+
+	QMetaObject::invokeMethod(
+		  this, [this] { emit finished(failed ? 0 : count); },
+		  Qt::QueuedConnection);
+}
+
+bool BzardHistoryExport::writeAll(std::stop_token stop,
+                                  const QByteArray &DATA) {
+	auto data = DATA.constData();
+	auto left = static_cast<size_t>(DATA.size());
+	while (left) {
+		pollfd ready{fd, POLLOUT, 0};
+		auto polled = ::poll(&ready, 1, POLL_INTERVAL_MS);
+		if (stop.stop_requested())
+			return false;
+		if (polled < 0 && errno != EINTR) {
+			qWarning() << Q_FUNC_INFO << "Export failed:" << strerror(errno);
+			return false;
+		}
+		if (polled <= 0)
+			continue;
+
+		// No more than a pipe takes at once, so a write never blocks
+		auto written = ::write(fd, data, qMin(left, size_t{PIPE_BUF}));
+		if (written < 0) {
+			if (errno == EINTR || errno == EAGAIN)
+				continue;
+			qWarning() << Q_FUNC_INFO << "Export failed:" << strerror(errno);
+			return false;
+		}
+		data += written;
+		left -= static_cast<size_t>(written);
+	}
+	return true;
+}
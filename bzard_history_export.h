@@ -0,0 +1,90 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <QByteArray>
+#include <QObject>
+#include <QTimer>
+
+#include "bzard_history_entry.h"
+
+/*
+ * One JSON Lines export into a file descriptor opened by the caller.
+ *
+ * Entries are looked up and encoded on the GUI thread, one chunk per
+ * event loop pass, and written out by a thread of its own. Encoding
+ * pauses while the writer lags behind, so a slow reader on the other end
+ * costs neither GUI time nor memory.
+ */
+class BzardHistoryExport : public QObject {
+	Q_OBJECT
+
+  public:
+	using SerialT = quint32;
+	// Nothing once the entry is gone
+	using LookupT = std::function<std::optional<BzardHistoryEntry>(SerialT)>;
+
+	// Owns fd from here on; entries are written in the order of serials
+	BzardHistoryExport(int fd, std::vector<SerialT> serials, LookupT lookup,
+	                   QObject *parent = nullptr);
+	~BzardHistoryExport() override;
+
+  signals:
+	// Entries written, 0 if writing failed
+	void finished(uint count);
+
+  private:
+	static constexpr size_t CHUNK_ENTRIES = 256;
+	static constexpr qsizetype MAX_QUEUED_BYTES = 1 << 20;
+	static constexpr int BACKLOG_INTERVAL_MS = 50;
+
+	const int fd;
+	const std::vector<SerialT> serials;
+	const LookupT lookup;
+
+	/*
+	 * GUI thread
+	 */
+	size_t next{0};
+	uint count{0};
+	QTimer pump;
+
+	/*
+	 * Shared with the writer
+	 */
+	std::mutex mutex;
+	std::condition_variable_any wakeUp;
+	std::deque<QByteArray> chunks;
+	qsizetype queuedBytes{0};
+	bool done{false};
+	bool failed{false};
+	std::jthread writer;
+
+	void encodeChunk();
+	void writeLoop(std::stop_token stop);
+	bool writeAll(std::stop_token stop, const QByteArray &DATA);
+};
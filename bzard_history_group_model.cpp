@@ -0,0 +1,339 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_history_group_model.h"
+
+#include <algorithm>
+#include <functional>
+
+BzardHistoryGroupModel::BzardHistoryGroupModel(BzardHistory::PtrT history)
+	  : bzardHistory{history} {
+	auto source = bzardHistory->model();
+	connect(source, &QAbstractItemModel::rowsInserted, this,
+	        &BzardHistoryGroupModel::onRowsInserted);
+	connect(source, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+	        &BzardHistoryGroupModel::onRowsAboutToBeRemoved);
+	connect(source, &QAbstractItemModel::dataChanged, this,
+	        &BzardHistoryGroupModel::onDataChanged);
+	connect(source, &QAbstractItemModel::modelReset, this,
+	        &BzardHistoryGroupModel::onModelReset);
+}
+
+void BzardHistoryGroupModel::populate() {
+	if (populated)
+		return;
+
+	beginResetModel();
+	rebuild();
+	populated = true;
+	endResetModel();
+}
+
+void BzardHistoryGroupModel::remove(const QModelIndex &index) {
+	if (!index.isValid())
+		return;
+
+	auto group = static_cast<Group *>(index.internalPointer());
+	if (!group) {
+		bzardHistory->clearApplication(groups[index.row()]->application);
+		return;
+	}
+	auto row = bzardHistory->rowOfSerial(group->serials[index.row()]);
+	if (row)
+		bzardHistory->remove(static_cast<uint>(*row));
+}
+
+QModelIndex BzardHistoryGroupModel::index(int row, int column,
+                                          const QModelIndex &parent) const {
+	if (row < 0 || row >= rowCount(parent) || column != 0)
+		return {};
+	if (!parent.isValid())
+		return createIndex(row, column);
+	// Children point at their group, groups at nothing
+	return createIndex(row, column, groups[parent.row()].get());
+}
+
+QModelIndex BzardHistoryGroupModel::parent(const QModelIndex &child) const {
+	if (!child.isValid())
+		return {};
+	return groupIndex(static_cast<const Group *>(child.internalPointer()));
+}
+
+int BzardHistoryGroupModel::rowCount(const QModelIndex &parent) const {
+	if (!parent.isValid())
+		return static_cast<int>(groups.size());
+	if (parent.internalPointer())
+		return 0;
+	return static_cast<int>(groups[parent.row()]->serials.size());
+}
+
+int BzardHistoryGroupModel::columnCount(const QModelIndex &parent) const {
+	return 1;
+	Q_UNUSED(parent)
+}
+
+QVariant BzardHistoryGroupModel::data(const QModelIndex &index,
+                                      int role) const {
+	if (!index.isValid())
+		return {};
+
+	auto group = static_cast<const Group *>(index.internalPointer());
+	if (group) {
+		auto row = bzardHistory->rowOfSerial(group->serials[index.row()]);
+		if (!row)
+			return {};
+		auto source = bzardHistory->model();
+		return source->data(source->index(static_cast<int>(*row)), role);
+	}
+
+	group = groups[index.row()].get();
+	switch (role) {
+	case BzardHistoryModel::HR_APPLICATION_ROLE:
+		return group->application;
+		break;
+	case BzardHistoryModel::HR_TIMESTAMP_ROLE:
+		return QDateTime::fromMSecsSinceEpoch(group->latest);
+		break;
+	case GR_COUNT_ROLE:
+		return static_cast<int>(group->serials.size());
+		break;
+	default:
+		break;
+	}
+	return {};
+}
+
+bool BzardHistoryGroupModel::canFetchMore(const QModelIndex &parent) const {
+	return !parent.isValid() && bzardHistory->model()->canFetchMore({});
+}
+
+void BzardHistoryGroupModel::fetchMore(const QModelIndex &parent) {
+	if (!parent.isValid())
+		bzardHistory->model()->fetchMore({});
+}
+
+QHash<int, QByteArray> BzardHistoryGroupModel::roleNames() const {
+	auto roles = bzardHistory->model()->roleNames();
+	roles[GR_COUNT_ROLE] = "count";
+	return roles;
+}
+
+void BzardHistoryGroupModel::onRowsInserted(const QModelIndex &parent,
+                                            int first, int last) {
+	Q_UNUSED(parent)
+	if (!populated)
+		return;
+
+	// New serials per group, newest first; groups in order of first hit
+	std::vector<std::pair<QString, std::vector<SerialT>>> added;
+	QHash<QString, size_t> addedAt;
+	for (auto i = first; i <= last; ++i) {
+		auto row = static_cast<size_t>(i);
+		auto application = bzardHistory->entry(i).application;
+		auto at = addedAt.value(application, added.size());
+		if (at == added.size()) {
+			addedAt.insert(application, at);
+			added.push_back({application, {}});
+		}
+		added[at].second.push_back(bzardHistory->serialAt(row));
+	}
+
+	// New entries arrive on top, fetched pages at the bottom; either way
+	// they are one contiguous run of children per group
+	for (auto it = added.rbegin(); it != added.rend(); ++it) {
+		auto &[application, serials] = *it;
+		auto group = byApplication.value(application);
+		if (!group) {
+			auto created = std::make_unique<Group>();
+			created->application = application;
+			created->serials = std::move(serials);
+			group = created.get();
+			updateLatest(group);
+
+			auto row = static_cast<int>(groups.size());
+			beginInsertRows({}, row, row);
+			groups.push_back(std::move(created));
+			byApplication.insert(application, group);
+			endInsertRows();
+			reposition(row);
+			continue;
+		}
+
+		auto &children = group->serials;
+		auto at = std::lower_bound(children.begin(), children.end(),
+		                           serials.front(), std::greater<>{});
+		auto child = static_cast<int>(at - children.begin());
+		beginInsertRows(groupIndex(group), child,
+		                child + static_cast<int>(serials.size()) - 1);
+		children.insert(at, serials.cbegin(), serials.cend());
+		endInsertRows();
+
+		auto index = groupIndex(group);
+		if (child) {
+			emit dataChanged(index, index, {GR_COUNT_ROLE});
+			continue;
+		}
+		updateLatest(group);
+		emit dataChanged(index, index,
+		                 {BzardHistoryModel::HR_TIMESTAMP_ROLE, GR_COUNT_ROLE});
+		reposition(groupRow(group));
+	}
+}
+
+/*
+ * The removed source rows hold a contiguous run of serials, so within
+ * every group they are one contiguous run of children.
+ */
+void BzardHistoryGroupModel::onRowsAboutToBeRemoved(const QModelIndex &parent,
+                                                    int first, int last) {
+	Q_UNUSED(parent)
+	if (!populated)
+		return;
+
+	auto newest = bzardHistory->serialAt(static_cast<size_t>(first));
+	auto oldest = bzardHistory->serialAt(static_cast<size_t>(last));
+	for (auto row = static_cast<int>(groups.size()) - 1; row >= 0; --row) {
+		auto group = groups[row].get();
+		auto &serials = group->serials;
+		auto begin = std::lower_bound(serials.begin(), serials.end(), newest,
+		                              std::greater<>{});
+		auto end = std::upper_bound(begin, serials.end(), oldest,
+		                            std::greater<>{});
+		if (begin == end)
+			continue;
+
+		if (begin == serials.begin() && end == serials.end()) {
+			beginRemoveRows({}, row, row);
+			byApplication.remove(group->application);
+			groups.erase(groups.begin() + row);
+			endRemoveRows();
+			continue;
+		}
+
+		auto wasNewest = begin == serials.begin();
+		beginRemoveRows(groupIndex(group),
+		                static_cast<int>(begin - serials.begin()),
+		                static_cast<int>(end - serials.begin()) - 1);
+		serials.erase(begin, end);
+		endRemoveRows();
+
+		auto index = groupIndex(group);
+		if (!wasNewest) {
+			emit dataChanged(index, index, {GR_COUNT_ROLE});
+			continue;
+		}
+		updateLatest(group);
+		emit dataChanged(index, index,
+		                 {BzardHistoryModel::HR_TIMESTAMP_ROLE, GR_COUNT_ROLE});
+		reposition(row);
+	}
+}
+
+void BzardHistoryGroupModel::onDataChanged(const QModelIndex &topLeft,
+                                           const QModelIndex &bottomRight,
+                                           const QList<int> &roles) {
+	if (!populated)
+		return;
+
+	for (auto i = topLeft.row(); i <= bottomRight.row(); ++i) {
+		auto row = static_cast<size_t>(i);
+		auto group = byApplication.value(bzardHistory->entry(i).application);
+		if (!group)
+			continue;
+
+		auto serial = bzardHistory->serialAt(row);
+		auto &serials = group->serials;
+		auto found = std::lower_bound(serials.cbegin(), serials.cend(), serial,
+		                              std::greater<>{});
+		if (found == serials.cend() || *found != serial)
+			continue;
+
+		auto child = static_cast<int>(found - serials.cbegin());
+		auto index = createIndex(child, 0, group);
+		emit dataChanged(index, index, roles);
+	}
+}
+
+void BzardHistoryGroupModel::onModelReset() {
+	if (!populated)
+		return;
+
+	beginResetModel();
+	rebuild();
+	endResetModel();
+}
+
+void BzardHistoryGroupModel::rebuild() {
+	groups.clear();
+	byApplication.clear();
+
+	// Rows are newest first, so groups come out ordered by newest entry
+	auto rows = static_cast<size_t>(bzardHistory->model()->rowCount({}));
+	for (size_t row = 0; row < rows; ++row) {
+		auto entry = bzardHistory->entry(static_cast<int>(row));
+		auto group = byApplication.value(entry.application);
+		if (!group) {
+			groups.push_back(std::make_unique<Group>());
+			group = groups.back().get();
+			group->application = entry.application;
+			group->latest = entry.timestamp;
+			byApplication.insert(entry.application, group);
+		}
+		group->serials.push_back(bzardHistory->serialAt(row));
+	}
+}
+
+int BzardHistoryGroupModel::groupRow(const Group *group) const {
+	auto found = std::find_if(
+		  groups.cbegin(), groups.cend(),
+		  [group](const GroupPtrT &GROUP) { return GROUP.get() == group; });
+	return static_cast<int>(found - groups.cbegin());
+}
+
+QModelIndex BzardHistoryGroupModel::groupIndex(const Group *group) const {
+	if (!group)
+		return {};
+	return createIndex(groupRow(group), 0);
+}
+
+void BzardHistoryGroupModel::updateLatest(Group *group) {
+	auto row = bzardHistory->rowOfSerial(group->serials.front());
+	group->latest = row ? bzardHistory->timestampAt(*row) : 0;
+}
+
+// Moves a group whose newest entry changed back into order
+void BzardHistoryGroupModel::reposition(int row) {
+	auto newest = groups[row]->serials.front();
+	auto target = static_cast<int>(
+		  std::count_if(groups.cbegin(), groups.cend(),
+	                    [&](const GroupPtrT &GROUP) {
+							return GROUP != groups[row] &&
+			                       GROUP->serials.front() > newest;
+						}));
+	if (target == row)
+		return;
+
+	// Destination is counted before the move
+	beginMoveRows({}, row, row, {}, target < row ? target : target + 1);
+	if (target < row)
+		std::rotate(groups.begin() + target, groups.begin() + row,
+		            groups.begin() + row + 1);
+	else
+		std::rotate(groups.begin() + row, groups.begin() + row + 1,
+		            groups.begin() + target + 1);
+	endMoveRows();
+}
@@ -0,0 +1,93 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <QAbstractItemModel>
+#include <QHash>
+
+#include "bzard_history.h"
+
+/*
+ * History grouped by application: top-level rows are applications,
+ * ordered by their newest entry, children are that application's
+ * entries, newest first.
+ *
+ * Groups keep entry serials only and follow the flat model's inserts and
+ * removals; counts and latest timestamps are updated in place, nothing
+ * is regrouped. The model is filled on first use and covers the rows the
+ * flat model has fetched.
+ */
+class BzardHistoryGroupModel : public QAbstractItemModel {
+	Q_OBJECT
+  public:
+	enum GroupRoles {
+		GR_COUNT_ROLE = BzardHistoryModel::HR_TIMESTAMP_ROLE + 1
+	};
+
+	explicit BzardHistoryGroupModel(BzardHistory::PtrT history);
+
+	void populate();
+
+	// A group removes all of the application's entries
+	Q_INVOKABLE void remove(const QModelIndex &INDEX);
+
+	QModelIndex index(int row, int column,
+	                  const QModelIndex &parent = {}) const final;
+	QModelIndex parent(const QModelIndex &child) const final;
+	int rowCount(const QModelIndex &parent = {}) const final;
+	int columnCount(const QModelIndex &parent = {}) const final;
+	QVariant data(const QModelIndex &index, int role) const final;
+	bool canFetchMore(const QModelIndex &parent) const final;
+	void fetchMore(const QModelIndex &parent) final;
+	QHash<int, QByteArray> roleNames() const final;
+
+  private slots:
+	void onRowsInserted(const QModelIndex &parent, int first, int last);
+	void onRowsAboutToBeRemoved(const QModelIndex &parent, int first,
+	                            int last);
+	void onDataChanged(const QModelIndex &topLeft,
+	                   const QModelIndex &bottomRight,
+	                   const QList<int> &roles);
+	void onModelReset();
+
+  private:
+	using SerialT = BzardHistory::SerialT;
+
+	struct Group {
+		QString application;
+		// Newest first
+		std::vector<SerialT> serials;
+		qint64 latest{0};
+	};
+	using GroupPtrT = std::unique_ptr<Group>;
+
+	BzardHistory *bzardHistory;
+	bool populated{false};
+	// Ordered by newest entry
+	std::vector<GroupPtrT> groups;
+	QHash<QString, Group *> byApplication;
+
+	void rebuild();
+	int groupRow(const Group *GROUP) const;
+	QModelIndex groupIndex(const Group *GROUP) const;
+	void updateLatest(Group *group);
+	void reposition(int row);
+};
@@ -0,0 +1,193 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_history_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+template <class F> void for_each_word(const QString &TEXT, F &&f) {
+	qsizetype start{-1};
+	for (qsizetype i = 0; i <= TEXT.size(); ++i) {
+		auto word = i < TEXT.size() && TEXT[i].isLetterOrNumber();
+		if (word && start < 0) {
+			start = i;
+		} else if (!word && start >= 0) {
+			f(TEXT.mid(start, i - start).toCaseFolded());
+			start = -1;
+		}
+	}
+}
+} // namespace
+
+void BzardHistoryIndex::add(SerialT serial, const QStringList &texts) {
+	for (const auto &TOKEN : tokens(texts))
+		postings[TOKEN].insert(serial);
+}
+
+void BzardHistoryIndex::remove(SerialT serial, const QStringList &texts) {
+	for (const auto &TOKEN : tokens(texts)) {
+		auto found = postings.find(TOKEN);
+		if (found != postings.end() && !found->second.erase(serial))
+			postings.erase(found);
+	}
+}
+
+void BzardHistoryIndex::clear() { postings.clear(); }
+
+std::vector<BzardHistoryIndex::SerialT>
+BzardHistoryIndex::search(const QString &queryString) const {
+	auto query = parse(queryString);
+	if (query.words.isEmpty())
+		return {};
+
+	SerialsT prefixMatches;
+	std::vector<RangeT> lists;
+	for (qsizetype i = 0; i < query.words.size(); ++i) {
+		const auto &WORD = query.words[i];
+		if (query.lastIsPrefix && i == query.words.size() - 1) {
+			prefixMatches = prefixPosting(WORD);
+			lists.push_back(prefixMatches);
+			continue;
+		}
+		auto found = postings.find(WORD);
+		if (found == postings.end())
+			return {};
+		lists.push_back(found->second.live());
+	}
+
+	// Intersect starting from the rarest word
+	std::sort(lists.begin(), lists.end(),
+	          [](RangeT a, RangeT b) { return a.size() < b.size(); });
+	SerialsT result{lists.front().begin(), lists.front().end()};
+	for (auto it = std::next(lists.begin());
+	     it != lists.end() && !result.empty(); ++it) {
+		SerialsT narrowed;
+		std::set_intersection(result.begin(), result.end(), it->begin(),
+		                      it->end(), std::back_inserter(narrowed));
+		result = std::move(narrowed);
+	}
+	return result;
+}
+
+bool BzardHistoryIndex::matches(const QString &queryString,
+                                const QStringList &texts) {
+	auto query = parse(queryString);
+	if (query.words.isEmpty())
+		return true;
+
+	auto entryTokens = tokens(texts);
+	for (qsizetype i = 0; i < query.words.size(); ++i) {
+		const auto &WORD = query.words[i];
+		auto prefix = query.lastIsPrefix && i == query.words.size() - 1;
+		auto found = std::any_of(entryTokens.cbegin(), entryTokens.cend(),
+		                         [&](const QString &TOKEN) {
+									 return prefix ? TOKEN.startsWith(WORD)
+			                                       : TOKEN == WORD;
+								 });
+		if (!found)
+			return false;
+	}
+	return true;
+}
+
+bool BzardHistoryIndex::isEmptyQuery(const QString &queryString) {
+	return parse(queryString).words.isEmpty();
+}
+
+BzardHistoryIndex::Query BzardHistoryIndex::parse(const QString &queryString) {
+	Query query;
+	for_each_word(queryString,
+	              [&query](QString word) { query.words << std::move(word); });
+	query.lastIsPrefix =
+		  !query.words.isEmpty() && !queryString.back().isSpace() &&
+		  query.words.back().size() >= MIN_PREFIX_LENGTH;
+	return query;
+}
+
+QStringList BzardHistoryIndex::tokens(const QStringList &texts) {
+	QStringList result;
+	for (const auto &TEXT : texts)
+		for_each_word(TEXT, [&result](QString word) {
+			result << std::move(word);
+		});
+	result.removeDuplicates();
+	return result;
+}
+
+BzardHistoryIndex::SerialsT
+BzardHistoryIndex::prefixPosting(const QString &prefix) const {
+	// Every posting is sorted already: merge them instead of sorting all
+	using CursorT = std::pair<RangeT::iterator, RangeT::iterator>;
+	std::vector<CursorT> cursors;
+	for (auto it = postings.lower_bound(prefix);
+	     it != postings.end() && it->first.startsWith(prefix); ++it) {
+		auto live = it->second.live();
+		if (!live.empty())
+			cursors.emplace_back(live.begin(), live.end());
+	}
+
+	auto later = [](const CursorT &A, const CursorT &B) {
+		return *A.first > *B.first;
+	};
+	std::make_heap(cursors.begin(), cursors.end(), later);
+
+	SerialsT result;
+	while (!cursors.empty()) {
+		std::pop_heap(cursors.begin(), cursors.end(), later);
+		auto &cursor = cursors.back();
+		if (result.empty() || result.back() != *cursor.first)
+			result.push_back(*cursor.first);
+		if (++cursor.first == cursor.second)
+			cursors.pop_back();
+		else
+			std::push_heap(cursors.begin(), cursors.end(), later);
+	}
+	return result;
+}
+
+BzardHistoryIndex::RangeT BzardHistoryIndex::Posting::live() const {
+	return RangeT{serials}.subspan(start);
+}
+
+void BzardHistoryIndex::Posting::insert(SerialT serial) {
+	// Serials grow, so this is an append unless an entry is re-added
+	auto first = serials.begin() + static_cast<std::ptrdiff_t>(start);
+	auto at = std::lower_bound(first, serials.end(), serial);
+	if (at == serials.end() || *at != serial)
+		serials.insert(at, serial);
+}
+
+bool BzardHistoryIndex::Posting::erase(SerialT serial) {
+	auto first = serials.begin() + static_cast<std::ptrdiff_t>(start);
+	auto at = std::lower_bound(first, serials.end(), serial);
+	if (at != serials.end() && *at == serial) {
+		if (at == first)
+			++start;
+		else
+			serials.erase(at);
+	}
+
+	// Each trim moves at most as many serials as were dropped since the last
+	if (start && start * 2 >= serials.size()) {
+		serials.erase(serials.begin(),
+		              serials.begin() + static_cast<std::ptrdiff_t>(start));
+		start = 0;
+	}
+	return !serials.empty();
+}
@@ -0,0 +1,82 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <span>
+#include <vector>
+
+#include <QString>
+#include <QStringList>
+
+/*
+ * Inverted token index over history text.
+ *
+ * Every entry is identified by a serial that only grows, so posting lists
+ * stay sorted by appending. Insertions and removals touch only the
+ * postings of the entry's own tokens; the index is never rebuilt.
+ */
+class BzardHistoryIndex {
+  public:
+	using SerialT = quint32;
+
+	void add(SerialT serial, const QStringList &TEXTS);
+	void remove(SerialT serial, const QStringList &TEXTS);
+	void clear();
+
+	/*
+	 * All words must match; the last one also matches as a prefix while
+	 * it is being typed. Returns serials in ascending order.
+	 */
+	std::vector<SerialT> search(const QString &QUERY) const;
+	static bool matches(const QString &QUERY, const QStringList &TEXTS);
+	// True when the query has no words and so matches everything
+	static bool isEmptyQuery(const QString &QUERY);
+
+  private:
+	using SerialsT = std::vector<SerialT>;
+	using RangeT = std::span<const SerialT>;
+
+	/*
+	 * Serials ascending. Eviction removes the oldest ones, which only moves
+	 * start; the removed head is trimmed once it is half of the list.
+	 */
+	struct Posting {
+		SerialsT serials;
+		size_t start{0};
+
+		RangeT live() const;
+		void insert(SerialT serial);
+		// False once nothing is left
+		bool erase(SerialT serial);
+	};
+
+	// Prefixes shorter than this are matched as whole words only
+	static constexpr auto MIN_PREFIX_LENGTH = 2;
+
+	std::map<QString, Posting> postings;
+
+	struct Query {
+		QStringList words;
+		bool lastIsPrefix{false};
+	};
+
+	static Query parse(const QString &QUERY);
+	static QStringList tokens(const QStringList &TEXTS);
+	SerialsT prefixPosting(const QString &PREFIX) const;
+};
@@ -0,0 +1,450 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_history_log.h"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+
+namespace {
+constexpr auto CRC32_TABLE = [] {
+	std::array<quint32, 256> table{};
+	for (quint32 i = 0; i < table.size(); ++i) {
+		auto crc = i;
+		for (auto bit = 0; bit < 8; ++bit)
+			crc = (crc & 1) ? 0xedb88320 ^ (crc >> 1) : crc >> 1;
+		table[i] = crc;
+	}
+	return table;
+}();
+
+quint32 crc32(const char *data, qsizetype size) {
+	quint32 crc{0xffffffff};
+	for (qsizetype i = 0; i < size; ++i)
+		crc = CRC32_TABLE[(crc ^ static_cast<uchar>(data[i])) & 0xff] ^
+		      (crc >> 8);
+	return crc ^ 0xffffffff;
+}
+
+// Make renames in the directory durable
+void sync_directory(const QString &DIRECTORY) {
+	auto fd = ::open(QFile::encodeName(DIRECTORY).constData(),
+	                 O_RDONLY | O_DIRECTORY);
+	if (fd < 0)
+		return;
+	::fsync(fd);
+	::close(fd);
+}
+} // namespace
+
+BzardHistoryLog::BzardHistoryLog(const QString &directory_)
+	  : directory{directory_} {}
+
+BzardHistoryLog::~BzardHistoryLog() {
+	// Let the writer commit whatever is still queued
+	if (writer.joinable()) {
+		writer.request_stop();
+		writer.join();
+	}
+}
+
+bool BzardHistoryLog::open() {
+	if (!QDir{}.mkpath(directory)) {
+		qWarning() << Q_FUNC_INFO << "Can't create" << directory;
+		return false;
+	}
+
+	logFile.setFileName(directory + "/history.log");
+	indexFile.setFileName(directory + "/history.idx");
+	if (!finishCompaction() || !openFiles())
+		return false;
+
+	if (!recover()) {
+		qWarning() << Q_FUNC_INFO << "Can't recover history log in"
+				   << directory;
+		return false;
+	}
+	if (compact()) {
+		logFile.close();
+		indexFile.close();
+		if (!finishCompaction() || !openFiles() || !recover()) {
+			qWarning() << Q_FUNC_INFO << "Can't reopen compacted history in"
+					   << directory;
+			return false;
+		}
+	}
+	map();
+
+	writerLog.setFileName(logFile.fileName());
+	writerIndex.setFileName(indexFile.fileName());
+	if (!writerLog.open(QIODevice::ReadWrite) ||
+	    !writerIndex.open(QIODevice::ReadWrite)) {
+		qWarning() << Q_FUNC_INFO << "Can't open history log for writing";
+		return false;
+	}
+	writer = std::jthread{[this](std::stop_token stop) { writeLoop(stop); }};
+	return true;
+}
+
+std::vector<BzardHistoryLog::SlotT> BzardHistoryLog::liveSlots() const {
+	std::vector<SlotT> result;
+	result.reserve(mappedSlots);
+	for (SlotT slot = 0; slot < mappedSlots; ++slot)
+		if (!(indexMap[slot].flags & IF_REMOVED))
+			result.push_back(slot);
+	return result;
+}
+
+std::optional<BzardHistoryEntry> BzardHistoryLog::read(SlotT slot) const {
+	auto payload = checkedPayload(slot);
+	if (!payload)
+		return {};
+	return deserialize(payload, indexMap[slot].size);
+}
+
+BzardHistoryLog::SlotT
+BzardHistoryLog::append(const BzardHistoryEntry &record) {
+	auto slot = nextSlot++;
+	enqueue({slot, record});
+	return slot;
+}
+
+void BzardHistoryLog::remove(SlotT slot) { enqueue({slot, std::nullopt}); }
+
+const char *BzardHistoryLog::checkedPayload(SlotT slot) const {
+	if (slot >= mappedSlots)
+		return nullptr;
+
+	const auto &ENTRY = indexMap[slot];
+	auto end = ENTRY.offset + sizeof(RecordHeader) + ENTRY.size;
+	if (end > static_cast<quint64>(logMapSize))
+		return nullptr;
+
+	RecordHeader header;
+	std::memcpy(&header, logMap + ENTRY.offset, sizeof header);
+	if (header.magic != RECORD_MAGIC || header.size != ENTRY.size)
+		return nullptr;
+
+	auto payload =
+		  reinterpret_cast<const char *>(logMap + ENTRY.offset + sizeof header);
+	if (crc32(payload, header.size) != header.checksum) {
+		qWarning() << Q_FUNC_INFO << "Checksum mismatch in slot" << slot;
+		return nullptr;
+	}
+	return payload;
+}
+
+bool BzardHistoryLog::openFiles() {
+	if (!logFile.open(QIODevice::ReadWrite) ||
+	    !indexFile.open(QIODevice::ReadWrite)) {
+		qWarning() << Q_FUNC_INFO << "Can't open history log in" << directory;
+		return false;
+	}
+	return true;
+}
+
+bool BzardHistoryLog::recover() {
+	auto logSize = static_cast<quint64>(logFile.size());
+	auto slots = static_cast<SlotT>(indexFile.size() / sizeof(IndexEntry));
+
+	// Drop index entries pointing past the log: torn commit
+	quint64 indexedEnd{0};
+	while (slots) {
+		IndexEntry entry;
+		if (!indexFile.seek((slots - 1) * sizeof(IndexEntry)) ||
+		    indexFile.read(reinterpret_cast<char *>(&entry), sizeof entry) !=
+		          sizeof entry)
+			return false;
+
+		auto end = entry.offset + sizeof(RecordHeader) + entry.size;
+		if (end <= logSize) {
+			indexedEnd = end;
+			break;
+		}
+		--slots;
+	}
+
+	// Records that reached the log but not the index
+	std::vector<IndexEntry> unindexed;
+	auto position = indexedEnd;
+	while (position + sizeof(RecordHeader) <= logSize) {
+		RecordHeader header;
+		if (!logFile.seek(position) ||
+		    logFile.read(reinterpret_cast<char *>(&header), sizeof header) !=
+		          sizeof header)
+			break;
+		if (header.magic != RECORD_MAGIC ||
+		    position + sizeof header + header.size > logSize)
+			break;
+		auto payload = logFile.read(header.size);
+		if (crc32(payload.constData(), payload.size()) != header.checksum)
+			break;
+
+		unindexed.push_back({position, header.size, 0});
+		position += sizeof header + header.size;
+	}
+
+	if (!indexFile.resize(slots * sizeof(IndexEntry)))
+		return false;
+	if (!unindexed.empty()) {
+		auto bytes = static_cast<qint64>(unindexed.size() * sizeof(IndexEntry));
+		if (!indexFile.seek(slots * sizeof(IndexEntry)) ||
+		    indexFile.write(reinterpret_cast<const char *>(unindexed.data()),
+		                    bytes) != bytes)
+			return false;
+		slots += static_cast<SlotT>(unindexed.size());
+	}
+	if (position < logSize && !logFile.resize(position))
+		return false;
+
+	nextSlot = slots;
+	indexedSlots = slots;
+	logEnd = position;
+	return true;
+}
+
+bool BzardHistoryLog::compact() {
+	std::vector<IndexEntry> index(nextSlot);
+	auto indexBytes = static_cast<qint64>(index.size() * sizeof(IndexEntry));
+	if (!indexFile.seek(0) ||
+	    indexFile.read(reinterpret_cast<char *>(index.data()), indexBytes) !=
+	          indexBytes)
+		return false;
+
+	quint64 liveBytes{0};
+	for (const auto &ENTRY : index)
+		if (!(ENTRY.flags & IF_REMOVED))
+			liveBytes += sizeof(RecordHeader) + ENTRY.size;
+	auto deadBytes = logEnd > liveBytes ? logEnd - liveBytes : 0;
+	if (deadBytes < COMPACT_MIN_BYTES || deadBytes * 2 < logEnd)
+		return false;
+
+	QFile compacted{logFile.fileName() + ".new"};
+	if (!compacted.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		qWarning() << Q_FUNC_INFO << compacted.errorString();
+		return false;
+	}
+	for (const auto &ENTRY : index) {
+		if (ENTRY.flags & IF_REMOVED)
+			continue;
+
+		// Unreadable records would stop the rescan of the new log
+		auto size = static_cast<qint64>(sizeof(RecordHeader) + ENTRY.size);
+		if (!logFile.seek(static_cast<qint64>(ENTRY.offset)))
+			continue;
+		auto record = logFile.read(size);
+		RecordHeader header;
+		if (record.size() != size)
+			continue;
+		std::memcpy(&header, record.constData(), sizeof header);
+		if (header.magic != RECORD_MAGIC || header.size != ENTRY.size ||
+		    crc32(record.constData() + sizeof header, header.size) !=
+		          header.checksum)
+			continue;
+
+		if (compacted.write(record) != size) {
+			qWarning() << Q_FUNC_INFO << compacted.errorString();
+			compacted.remove();
+			return false;
+		}
+	}
+	if (!compacted.flush() || ::fsync(compacted.handle()) != 0) {
+		qWarning() << Q_FUNC_INFO << compacted.errorString();
+		compacted.remove();
+		return false;
+	}
+	compacted.close();
+
+	// A complete .compacted file is the commit point, see finishCompaction()
+	if (!compacted.rename(logFile.fileName() + ".compacted")) {
+		qWarning() << Q_FUNC_INFO << compacted.errorString();
+		compacted.remove();
+		return false;
+	}
+	sync_directory(directory);
+	return true;
+}
+
+bool BzardHistoryLog::finishCompaction() {
+	// Leftover of a compaction interrupted before its commit point
+	QFile::remove(logFile.fileName() + ".new");
+
+	auto compacted = logFile.fileName() + ".compacted";
+	if (!QFile::exists(compacted))
+		return true;
+
+	// The index describes the old log; recover() rebuilds it from the new one
+	if (indexFile.exists() && !indexFile.remove()) {
+		qWarning() << Q_FUNC_INFO << indexFile.errorString();
+		return false;
+	}
+	if (std::rename(QFile::encodeName(compacted).constData(),
+	                QFile::encodeName(logFile.fileName()).constData())) {
+		qWarning() << Q_FUNC_INFO << "Can't replace" << logFile.fileName();
+		return false;
+	}
+	sync_directory(directory);
+	return true;
+}
+
+void BzardHistoryLog::map() {
+	if (nextSlot) {
+		auto indexData = indexFile.map(0, nextSlot * sizeof(IndexEntry));
+		indexMap = reinterpret_cast<const IndexEntry *>(indexData);
+		mappedSlots = indexMap ? nextSlot : 0;
+	}
+	if (logEnd) {
+		logMap = logFile.map(0, static_cast<qint64>(logEnd));
+		logMapSize = logMap ? static_cast<qint64>(logEnd) : 0;
+	}
+}
+
+void BzardHistoryLog::enqueue(Job job) {
+	{
+		std::lock_guard lock{mutex};
+		pending.push_back(std::move(job));
+	}
+	wakeUp.notify_one();
+}
+
+void BzardHistoryLog::writeLoop(std::stop_token stop) {
+	std::vector<Job> batch;
+	while (true) {
+		{
+			std::unique_lock lock{mutex};
+			if (batch.empty()) {
+				wakeUp.wait(lock, stop, [this] { return !pending.empty(); });
+				// Stop requested and nothing left to commit
+				if (pending.empty())
+					return;
+			} else {
+				// A failed commit is retried ahead of anything queued since
+				wakeUp.wait_for(lock, stop, RETRY_INTERVAL,
+				                [] { return false; });
+			}
+			batch.insert(batch.end(), std::make_move_iterator(pending.begin()),
+			             std::make_move_iterator(pending.end()));
+			pending.clear();
+		}
+		// Everything queued while the previous commit ran goes in one commit
+		if (commit(batch)) {
+			batch.clear();
+		} else if (stop.stop_requested()) {
+			qWarning() << Q_FUNC_INFO << "Dropping" << batch.size()
+					   << "uncommitted history changes";
+			return;
+		}
+	}
+}
+
+bool BzardHistoryLog::commit(const std::vector<Job> &batch) {
+	QByteArray records;
+	QByteArray entries;
+	for (const auto &JOB : batch) {
+		if (!JOB.record)
+			continue;
+
+		auto payload = serialize(*JOB.record);
+		RecordHeader header{RECORD_MAGIC, static_cast<quint32>(payload.size()),
+		                    crc32(payload.constData(), payload.size())};
+		IndexEntry entry{logEnd + records.size(), header.size, 0};
+
+		records.append(reinterpret_cast<const char *>(&header), sizeof header);
+		records.append(payload);
+		entries.append(reinterpret_cast<const char *>(&entry), sizeof entry);
+	}
+
+	// Log first: an index entry must never point at missing data. Nothing
+	// advances until the whole batch is on disk, so a retry rewrites the
+	// same bytes at the same positions.
+	if (!records.isEmpty() && (!writeAt(writerLog, logEnd, records) ||
+	                           ::fdatasync(writerLog.handle()) != 0))
+		return false;
+
+	// Slots are handed out in queue order, so new entries are contiguous
+	if (!entries.isEmpty() &&
+	    !writeAt(writerIndex, indexedSlots * sizeof(IndexEntry), entries))
+		return false;
+
+	static constexpr quint32 REMOVED{IF_REMOVED};
+	const auto FLAGS = QByteArray::fromRawData(
+		  reinterpret_cast<const char *>(&REMOVED), sizeof REMOVED);
+	for (const auto &JOB : batch) {
+		if (JOB.record)
+			continue;
+		auto position =
+			  JOB.slot * sizeof(IndexEntry) + offsetof(IndexEntry, flags);
+		if (!writeAt(writerIndex, position, FLAGS))
+			return false;
+	}
+	if (::fdatasync(writerIndex.handle()) != 0)
+		return false;
+
+	logEnd += records.size();
+	indexedSlots += static_cast<SlotT>(entries.size() / sizeof(IndexEntry));
+	return true;
+}
+
+bool BzardHistoryLog::writeAt(QFile &file, quint64 position,
+                              const QByteArray &DATA) {
+	if (!file.seek(static_cast<qint64>(position)) ||
+	    file.write(DATA) != DATA.size() || !file.flush()) {
+		qWarning() << Q_FUNC_INFO << file.fileName() << file.errorString();
+		return false;
+	}
+	return true;
+}
+
+QByteArray BzardHistoryLog::serialize(const BzardHistoryEntry &record) {
+	QByteArray payload;
+	QDataStream stream{&payload, QIODevice::WriteOnly};
+	stream.setVersion(QDataStream::Qt_6_5);
+	stream << PAYLOAD_VERSION << record.id << record.application
+		   << record.title << record.body << record.iconUrl
+		   << record.timestamp;
+	return payload;
+}
+
+std::optional<BzardHistoryEntry>
+BzardHistoryLog::deserialize(const char *data, quint32 size) {
+	auto payload = QByteArray::fromRawData(data, static_cast<qsizetype>(size));
+	QDataStream stream{payload};
+	stream.setVersion(QDataStream::Qt_6_5);
+
+	quint8 version{0};
+	stream >> version;
+	if (version < 1 || version > PAYLOAD_VERSION)
+		return {};
+
+	BzardHistoryEntry record;
+	stream >> record.id >> record.application >> record.title >> record.body >>
+		  record.iconUrl;
+	if (version > 1)
+		stream >> record.timestamp;
+	if (stream.status() != QDataStream::Ok)
+		return {};
+	return record;
+}
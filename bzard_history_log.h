@@ -0,0 +1,132 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <QFile>
+#include <QString>
+
+#include "bzard_history_entry.h"
+
+/*
+ * Append-only on-disk history.
+ *
+ * history.log holds checksummed records, history.idx holds one fixed-size
+ * entry (offset, size, flags) per record. Both files are memory-mapped on
+ * open, so a restarted daemon gets its history back without decoding a
+ * single record; records are decoded only when somebody reads them.
+ *
+ * Writes go through a write-behind thread that commits everything queued
+ * since the previous commit with one fdatasync per file, so callers never
+ * block on the disk. A commit that fails stays queued and is retried.
+ *
+ * Removed records are only flagged in the index; once they make up half
+ * of the log it is rewritten with the live records alone on open.
+ */
+class BzardHistoryLog {
+  public:
+	using SlotT = quint32;
+
+	explicit BzardHistoryLog(const QString &directory);
+	~BzardHistoryLog();
+
+	bool open();
+
+	// Slots not removed at open time, oldest first
+	std::vector<SlotT> liveSlots() const;
+	std::optional<BzardHistoryEntry> read(SlotT slot) const;
+
+	SlotT append(const BzardHistoryEntry &record);
+	void remove(SlotT slot);
+
+  private:
+	struct IndexEntry {
+		quint64 offset;
+		quint32 size;
+		quint32 flags;
+	};
+	static_assert(sizeof(IndexEntry) == 16);
+
+	struct RecordHeader {
+		quint32 magic;
+		quint32 size;
+		quint32 checksum;
+	};
+
+	// Removals have no record
+	struct Job {
+		SlotT slot;
+		std::optional<BzardHistoryEntry> record;
+	};
+
+	enum IndexFlags : quint32 { IF_REMOVED = 1 };
+
+	static constexpr quint32 RECORD_MAGIC = 0x4c485a42; // "BZHL"
+	// Version 1 payloads have no timestamp
+	static constexpr quint8 PAYLOAD_VERSION = 2;
+
+	static constexpr quint64 COMPACT_MIN_BYTES = 1 << 20;
+	static constexpr std::chrono::seconds RETRY_INTERVAL{5};
+
+	const QString directory;
+
+	/*
+	 * Opened on the GUI thread, read-only after open()
+	 */
+	QFile logFile;
+	QFile indexFile;
+	const uchar *logMap{nullptr};
+	qint64 logMapSize{0};
+	const IndexEntry *indexMap{nullptr};
+	SlotT mappedSlots{0};
+	SlotT nextSlot{0};
+
+	/*
+	 * Write-behind state
+	 */
+	std::mutex mutex;
+	std::condition_variable_any wakeUp;
+	std::vector<Job> pending;
+	QFile writerLog;
+	QFile writerIndex;
+	quint64 logEnd{0};
+	SlotT indexedSlots{0};
+	std::jthread writer;
+
+	const char *checkedPayload(SlotT slot) const;
+	bool openFiles();
+	bool recover();
+	bool compact();
+	bool finishCompaction();
+	void map();
+	void enqueue(Job job);
+	void writeLoop(std::stop_token stop);
+	bool commit(const std::vector<Job> &batch);
+	bool writeAt(QFile &file, quint64 position, const QByteArray &DATA);
+
+	static QByteArray serialize(const BzardHistoryEntry &record);
+	static std::optional<BzardHistoryEntry> deserialize(const char *data,
+	                                                    quint32 size);
+};
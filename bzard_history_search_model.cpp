@@ -0,0 +1,252 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_history_search_model.h"
+
+#include <algorithm>
+#include <functional>
+
+BzardHistorySearchModel::BzardHistorySearchModel(BzardHistory::PtrT history)
+	  : bzardHistory{history} {
+	auto source = bzardHistory->model();
+	setSourceModel(source);
+
+	connect(source, &QAbstractItemModel::rowsAboutToBeInserted, this,
+	        &BzardHistorySearchModel::onRowsAboutToBeInserted);
+	connect(source, &QAbstractItemModel::rowsInserted, this,
+	        &BzardHistorySearchModel::onRowsInserted);
+	connect(source, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+	        &BzardHistorySearchModel::onRowsAboutToBeRemoved);
+	connect(source, &QAbstractItemModel::rowsRemoved, this,
+	        &BzardHistorySearchModel::onRowsRemoved);
+	connect(source, &QAbstractItemModel::dataChanged, this,
+	        &BzardHistorySearchModel::onDataChanged);
+	connect(source, &QAbstractItemModel::modelAboutToBeReset, this,
+	        &BzardHistorySearchModel::onModelAboutToBeReset);
+	connect(source, &QAbstractItemModel::modelReset, this,
+	        &BzardHistorySearchModel::onModelReset);
+}
+
+QString BzardHistorySearchModel::query() const { return query_; }
+
+void BzardHistorySearchModel::setQuery(const QString &query) {
+	if (query == query_)
+		return;
+
+	beginResetModel();
+	query_ = query;
+	runQuery();
+	endResetModel();
+	emit queryChanged();
+}
+
+void BzardHistorySearchModel::remove(int row) {
+	auto source = mapToSource(index(row, 0));
+	if (source.isValid())
+		bzardHistory->remove(static_cast<uint>(source.row()));
+}
+
+QModelIndex BzardHistorySearchModel::index(int row, int column,
+                                           const QModelIndex &parent) const {
+	if (parent.isValid() || row < 0 || row >= rowCount() || column != 0)
+		return {};
+	return createIndex(row, column);
+}
+
+QModelIndex BzardHistorySearchModel::parent(const QModelIndex &child) const {
+	return {};
+	Q_UNUSED(child)
+}
+
+int BzardHistorySearchModel::rowCount(const QModelIndex &parent) const {
+	if (parent.isValid())
+		return 0;
+	if (!filtering)
+		return sourceModel()->rowCount({});
+	return static_cast<int>(matches.size());
+}
+
+int BzardHistorySearchModel::columnCount(const QModelIndex &parent) const {
+	return parent.isValid() ? 0 : 1;
+}
+
+QModelIndex
+BzardHistorySearchModel::mapToSource(const QModelIndex &proxyIndex) const {
+	if (!proxyIndex.isValid())
+		return {};
+	if (!filtering)
+		return sourceModel()->index(proxyIndex.row(), 0);
+
+	auto row = bzardHistory->rowOfSerial(matches[proxyIndex.row()]);
+	if (!row)
+		return {};
+	return sourceModel()->index(static_cast<int>(*row), 0);
+}
+
+QModelIndex
+BzardHistorySearchModel::mapFromSource(const QModelIndex &sourceIndex) const {
+	if (!sourceIndex.isValid())
+		return {};
+	if (!filtering)
+		return index(sourceIndex.row(), 0);
+
+	auto row = static_cast<size_t>(sourceIndex.row());
+	auto serial = bzardHistory->serialAt(row);
+	auto found = std::lower_bound(matches.cbegin(), matches.cend(), serial,
+	                              std::greater<>{});
+	if (found == matches.cend() || *found != serial)
+		return {};
+	return index(static_cast<int>(std::distance(matches.cbegin(), found)), 0);
+}
+
+void BzardHistorySearchModel::onRowsAboutToBeInserted(const QModelIndex &parent,
+                                                      int first, int last) {
+	if (!filtering)
+		beginInsertRows({}, first, last);
+	Q_UNUSED(parent)
+}
+
+void BzardHistorySearchModel::onRowsInserted(const QModelIndex &parent,
+                                             int first, int last) {
+	Q_UNUSED(parent)
+	if (!filtering) {
+		endInsertRows();
+		return;
+	}
+
+	// Only the new rows are checked, the index is not queried again
+	std::vector<SerialT> inserted;
+	for (auto i = first; i <= last; ++i) {
+		auto row = static_cast<size_t>(i);
+		if (bzardHistory->rowMatches(row, query_))
+			inserted.push_back(bzardHistory->serialAt(row));
+	}
+	if (inserted.empty())
+		return;
+
+	auto at = std::lower_bound(matches.cbegin(), matches.cend(),
+	                           inserted.front(), std::greater<>{});
+	auto proxyFirst = static_cast<int>(std::distance(matches.cbegin(), at));
+	beginInsertRows({}, proxyFirst,
+	                proxyFirst + static_cast<int>(inserted.size()) - 1);
+	matches.insert(at, inserted.cbegin(), inserted.cend());
+	endInsertRows();
+}
+
+void BzardHistorySearchModel::onRowsAboutToBeRemoved(const QModelIndex &parent,
+                                                     int first, int last) {
+	Q_UNUSED(parent)
+	if (!filtering) {
+		beginRemoveRows({}, first, last);
+		return;
+	}
+
+	pendingRemoval = proxyRange(first, last);
+	if (pendingRemoval)
+		beginRemoveRows({}, pendingRemoval->first, pendingRemoval->second);
+}
+
+void BzardHistorySearchModel::onRowsRemoved(const QModelIndex &parent,
+                                            int first, int last) {
+	Q_UNUSED(parent)
+	Q_UNUSED(first)
+	Q_UNUSED(last)
+	if (!filtering) {
+		endRemoveRows();
+		return;
+	}
+	if (!pendingRemoval)
+		return;
+
+	auto begin = matches.begin() + pendingRemoval->first;
+	matches.erase(begin, matches.begin() + pendingRemoval->second + 1);
+	pendingRemoval.reset();
+	endRemoveRows();
+}
+
+void BzardHistorySearchModel::onDataChanged(const QModelIndex &topLeft,
+                                            const QModelIndex &bottomRight,
+                                            const QList<int> &roles) {
+	if (!filtering) {
+		emit dataChanged(index(topLeft.row(), 0), index(bottomRight.row(), 0),
+		                 roles);
+		return;
+	}
+
+	// Replaced rows may start or stop matching
+	for (auto i = topLeft.row(); i <= bottomRight.row(); ++i) {
+		auto row = static_cast<size_t>(i);
+		auto serial = bzardHistory->serialAt(row);
+		auto found = std::lower_bound(matches.begin(), matches.end(), serial,
+		                              std::greater<>{});
+		auto proxyRow = static_cast<int>(std::distance(matches.begin(), found));
+		auto present = found != matches.end() && *found == serial;
+		auto matching = bzardHistory->rowMatches(row, query_);
+		if (present && matching) {
+			emit dataChanged(index(proxyRow, 0), index(proxyRow, 0), roles);
+		} else if (present) {
+			beginRemoveRows({}, proxyRow, proxyRow);
+			matches.erase(found);
+			endRemoveRows();
+		} else if (matching) {
+			beginInsertRows({}, proxyRow, proxyRow);
+			matches.insert(found, serial);
+			endInsertRows();
+		}
+	}
+}
+
+void BzardHistorySearchModel::onModelAboutToBeReset() { beginResetModel(); }
+
+void BzardHistorySearchModel::onModelReset() {
+	runQuery();
+	endResetModel();
+}
+
+void BzardHistorySearchModel::runQuery() {
+	filtering = !BzardHistoryIndex::isEmptyQuery(query_);
+	matches.clear();
+	if (!filtering)
+		return;
+
+	// Only rows the source has fetched; later pages are checked on insert
+	auto rows = sourceModel()->rowCount({});
+	if (!rows)
+		return;
+	auto oldest = bzardHistory->serialAt(static_cast<size_t>(rows - 1));
+	auto found = bzardHistory->search(query_);
+	auto shown = std::lower_bound(found.cbegin(), found.cend(), oldest);
+	matches.assign(found.crbegin(), std::make_reverse_iterator(shown));
+}
+
+/*
+ * Source rows first..last hold a contiguous run of serials, so their
+ * matches are a contiguous run of proxy rows as well.
+ */
+std::optional<BzardHistorySearchModel::RangeT>
+BzardHistorySearchModel::proxyRange(int first, int last) const {
+	auto newest = bzardHistory->serialAt(static_cast<size_t>(first));
+	auto oldest = bzardHistory->serialAt(static_cast<size_t>(last));
+	auto begin = std::lower_bound(matches.cbegin(), matches.cend(), newest,
+	                              std::greater<>{});
+	auto end = std::upper_bound(begin, matches.cend(), oldest,
+	                            std::greater<>{});
+	if (begin == end)
+		return {};
+	return RangeT{static_cast<int>(std::distance(matches.cbegin(), begin)),
+	              static_cast<int>(std::distance(matches.cbegin(), end)) - 1};
+}
@@ -0,0 +1,84 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <QAbstractProxyModel>
+
+#include "bzard_history.h"
+
+/*
+ * History rows matching a search query, newest first.
+ *
+ * Matches are kept as entry serials and follow the source model's
+ * inserts and removals incrementally; only a query change re-runs the
+ * index search. An empty query passes every row through.
+ */
+class BzardHistorySearchModel : public QAbstractProxyModel {
+	Q_OBJECT
+	Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+  public:
+	explicit BzardHistorySearchModel(BzardHistory::PtrT history);
+
+	QString query() const;
+	void setQuery(const QString &QUERY);
+
+	Q_INVOKABLE void remove(int row);
+
+	QModelIndex index(int row, int column,
+	                  const QModelIndex &parent = {}) const final;
+	QModelIndex parent(const QModelIndex &child) const final;
+	int rowCount(const QModelIndex &parent = {}) const final;
+	int columnCount(const QModelIndex &parent = {}) const final;
+	QModelIndex mapToSource(const QModelIndex &proxyIndex) const final;
+	QModelIndex mapFromSource(const QModelIndex &sourceIndex) const final;
+
+  signals:
+	void queryChanged();
+
+  private slots:
+	void onRowsAboutToBeInserted(const QModelIndex &parent, int first,
+	                             int last);
+	void onRowsInserted(const QModelIndex &parent, int first, int last);
+	void onRowsAboutToBeRemoved(const QModelIndex &parent, int first,
+	                            int last);
+	void onRowsRemoved(const QModelIndex &parent, int first, int last);
+	void onDataChanged(const QModelIndex &topLeft,
+	                   const QModelIndex &bottomRight,
+	                   const QList<int> &roles);
+	void onModelAboutToBeReset();
+	void onModelReset();
+
+  private:
+	using SerialT = BzardHistory::SerialT;
+	// Proxy row range, both ends included
+	using RangeT = std::pair<int, int>;
+
+	BzardHistory *bzardHistory;
+	QString query_;
+	bool filtering{false};
+	// Serials of the matching rows, newest first
+	std::vector<SerialT> matches;
+	std::optional<RangeT> pendingRemoval;
+
+	void runQuery();
+	std::optional<RangeT> proxyRange(int first, int last) const;
+};
@@ -0,0 +1,227 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_history_storage.h"
+
+BzardHistoryStorage::BzardHistoryStorage(size_t capacity,
+                                         qsizetype packThreshold)
+	  : ids{capacity}, applications{capacity}, titles{capacity},
+		bodies{capacity}, iconUrls{capacity}, logSlots{capacity},
+		serials{capacity}, timestamps{capacity}, codec{packThreshold} {}
+
+size_t BzardHistoryStorage::size() const { return ids.size(); }
+
+bool BzardHistoryStorage::empty() const { return ids.empty(); }
+
+void BzardHistoryStorage::pushFront(const BzardHistoryEntry &entry,
+                                    SerialT serial, SlotT slot) {
+	ids.pushFront(entry.id);
+	applications.pushFront(strings.intern(entry.application));
+	titles.pushFront(texts.add(entry.title));
+	bodies.pushFront(makeBody(entry.body));
+	iconUrls.pushFront(strings.intern(entry.iconUrl));
+	logSlots.pushFront(slot);
+	serials.pushFront(serial);
+	timestamps.pushFront(entry.timestamp);
+}
+
+void BzardHistoryStorage::popBack(size_t count) {
+	for (; count && !empty(); --count) {
+		release(size() - 1);
+		ids.popBack();
+		applications.popBack();
+		titles.popBack();
+		bodies.popBack();
+		iconUrls.popBack();
+		logSlots.popBack();
+		serials.popBack();
+		timestamps.popBack();
+	}
+	// No compaction: the oldest pages empty as eviction goes on, moving
+	// their strings would only copy text that is next to go
+}
+
+void BzardHistoryStorage::erase(size_t index) {
+	release(index);
+	ids.erase(index);
+	applications.erase(index);
+	titles.erase(index);
+	bodies.erase(index);
+	iconUrls.erase(index);
+	logSlots.erase(index);
+	serials.erase(index);
+	timestamps.erase(index);
+	compactTexts();
+}
+
+void BzardHistoryStorage::erase(const std::vector<size_t> &indexes) {
+	for (auto index : indexes)
+		release(index);
+	ids.erase(indexes);
+	applications.erase(indexes);
+	titles.erase(indexes);
+	bodies.erase(indexes);
+	iconUrls.erase(indexes);
+	logSlots.erase(indexes);
+	serials.erase(indexes);
+	timestamps.erase(indexes);
+	compactTexts();
+}
+
+void BzardHistoryStorage::clear() { popBack(size()); }
+
+void BzardHistoryStorage::replace(size_t index, const BzardHistoryEntry &entry,
+                                  SlotT slot) {
+	release(index);
+	ids[index] = entry.id;
+	applications[index] = strings.intern(entry.application);
+	titles[index] = texts.add(entry.title);
+	bodies[index] = makeBody(entry.body);
+	iconUrls[index] = strings.intern(entry.iconUrl);
+	logSlots[index] = slot;
+	timestamps[index] = entry.timestamp;
+	compactTexts();
+}
+
+uint BzardHistoryStorage::id(size_t index) const { return ids[index]; }
+
+const QString &BzardHistoryStorage::application(size_t index) const {
+	return strings.string(applications[index]);
+}
+
+QString BzardHistoryStorage::title(size_t index) const {
+	return texts.text(titles[index]);
+}
+
+QString BzardHistoryStorage::body(size_t index) const {
+	const auto &BODY = bodies[index];
+	if (auto text = std::get_if<TextT>(&BODY))
+		return texts.text(*text);
+
+	auto serial = serials[index];
+	if (auto cached = unpackedBodies.object(serial))
+		return *cached;
+	auto text = codec.unpack(std::get<QByteArray>(BODY));
+	unpackedBodies.insert(serial, new QString{text});
+	return text;
+}
+
+const QString &BzardHistoryStorage::iconUrl(size_t index) const {
+	return strings.string(iconUrls[index]);
+}
+
+BzardHistoryStorage::SlotT BzardHistoryStorage::logSlot(size_t index) const {
+	return logSlots[index];
+}
+
+BzardHistoryStorage::SerialT BzardHistoryStorage::serial(size_t index) const {
+	return serials[index];
+}
+
+qint64 BzardHistoryStorage::timestamp(size_t index) const {
+	return timestamps[index];
+}
+
+BzardHistoryEntry BzardHistoryStorage::entry(size_t index) const {
+	return {id(index), application(index), title(index), body(index),
+	        iconUrl(index), timestamp(index)};
+}
+
+std::optional<size_t> BzardHistoryStorage::rowOfSerial(SerialT serial) const {
+	// Serials descend with the row number
+	size_t first{0}, last{size()};
+	while (first < last) {
+		auto middle = first + (last - first) / 2;
+		if (serials[middle] > serial)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	if (first < size() && serials[first] == serial)
+		return first;
+	return {};
+}
+
+qint64 BzardHistoryStorage::rowBytes(size_t index) const {
+	return ROW_BYTES + BzardTextArena::bytes(titles[index]) +
+	       storedBytes(bodies[index]);
+}
+
+qint64 BzardHistoryStorage::byteCount() const {
+	return static_cast<qint64>(size()) * ROW_BYTES + packedBytes +
+	       texts.byteCount() + strings.byteCount() + codec.byteCount();
+}
+
+qint64 BzardHistoryStorage::estimateBytes(const BzardHistoryEntry &entry) {
+	// Mostly ASCII, so about a byte per character
+	return ROW_BYTES + entry.title.size() + entry.body.size();
+}
+
+double BzardHistoryStorage::packRatio() const {
+	if (!packedBytes)
+		return 1;
+	return static_cast<double>(packedTextBytes) / packedBytes;
+}
+
+double BzardHistoryStorage::averageUnpackMicroseconds() const {
+	return codec.averageDecodeMicroseconds();
+}
+
+BzardHistoryStorage::BodyT BzardHistoryStorage::makeBody(const QString &text) {
+	if (codec.shouldPack(text)) {
+		auto packed = codec.pack(text);
+		if (!packed.isEmpty()) {
+			packedBytes += packed.size();
+			packedTextBytes += BzardBodyCodec::unpackedBytes(packed);
+			return packed;
+		}
+	}
+	return texts.add(text);
+}
+
+void BzardHistoryStorage::release(size_t index) {
+	strings.release(applications[index]);
+	texts.release(titles[index]);
+	strings.release(iconUrls[index]);
+
+	const auto &BODY = bodies[index];
+	if (auto text = std::get_if<TextT>(&BODY)) {
+		texts.release(*text);
+	} else if (auto packed = std::get_if<QByteArray>(&BODY)) {
+		packedBytes -= packed->size();
+		packedTextBytes -= BzardBodyCodec::unpackedBytes(*packed);
+		unpackedBodies.remove(serials[index]);
+	}
+}
+
+void BzardHistoryStorage::compactTexts() {
+	if (!texts.fragmented())
+		return;
+	texts.compact([this](auto relocate) {
+		for (size_t i = 0; i < size(); ++i) {
+			relocate(titles[i]);
+			if (auto text = std::get_if<TextT>(&bodies[i]))
+				relocate(*text);
+		}
+	});
+}
+
+qint64 BzardHistoryStorage::storedBytes(const BodyT &body) {
+	if (auto packed = std::get_if<QByteArray>(&body))
+		return packed->size();
+	return BzardTextArena::bytes(std::get<TextT>(body));
+}
@@ -0,0 +1,118 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <limits>
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include <QCache>
+#include <QString>
+
+#include "bzard_body_codec.h"
+#include "bzard_history_entry.h"
+#include "bzard_history_log.h"
+#include "bzard_ring_buffer.h"
+#include "bzard_string_pool.h"
+#include "bzard_text_arena.h"
+
+/*
+ * History entries stored column by column, newest first, in fixed-capacity
+ * rings. Application and icon repeat a lot and are interned; title and
+ * body go to a compact text arena and become QStrings only when read.
+ * Long bodies are kept compressed and unpacked on access, the last few
+ * stay unpacked.
+ */
+class BzardHistoryStorage {
+  public:
+	using SlotT = BzardHistoryLog::SlotT;
+	// Grows with every entry, so rows are ordered by serial too
+	using SerialT = quint32;
+	static constexpr SlotT NO_SLOT = std::numeric_limits<SlotT>::max();
+
+	BzardHistoryStorage(size_t capacity, qsizetype packThreshold);
+
+	size_t size() const;
+	bool empty() const;
+
+	void pushFront(const BzardHistoryEntry &ENTRY, SerialT serial,
+	               SlotT slot = NO_SLOT);
+	void popBack(size_t count = 1);
+	void erase(size_t index);
+	// Indexes ascending and unique; one pass over the rows after the first
+	void erase(const std::vector<size_t> &INDEXES);
+	void clear();
+	// Rewrites a row in place, keeping its serial
+	void replace(size_t index, const BzardHistoryEntry &ENTRY, SlotT slot);
+
+	uint id(size_t index) const;
+	const QString &application(size_t index) const;
+	QString title(size_t index) const;
+	QString body(size_t index) const;
+	const QString &iconUrl(size_t index) const;
+	SlotT logSlot(size_t index) const;
+	SerialT serial(size_t index) const;
+	qint64 timestamp(size_t index) const;
+	BzardHistoryEntry entry(size_t index) const;
+
+	std::optional<size_t> rowOfSerial(SerialT serial) const;
+
+	// Bytes a row holds on its own, i.e. at least what evicting it frees
+	qint64 rowBytes(size_t index) const;
+	qint64 byteCount() const;
+	static qint64 estimateBytes(const BzardHistoryEntry &ENTRY);
+
+	// Plain to packed size of the packed bodies, 1 when there are none
+	double packRatio() const;
+	double averageUnpackMicroseconds() const;
+
+  private:
+	using StringIdT = BzardStringPool::IdT;
+
+	using TextT = BzardTextArena::Ref;
+	// Compact text, or zstd-packed when long
+	using BodyT = std::variant<TextT, QByteArray>;
+
+	static constexpr qint64 ROW_BYTES =
+		  sizeof(uint) + 2 * sizeof(StringIdT) + sizeof(TextT) + sizeof(BodyT) +
+		  sizeof(SlotT) + sizeof(SerialT) + sizeof(qint64);
+	static constexpr auto UNPACKED_BODIES = 32;
+
+	BzardStringPool strings;
+	// Titles and bodies are rarely shared, so they are not interned
+	BzardTextArena texts;
+	BzardRingBuffer<uint> ids;
+	BzardRingBuffer<StringIdT> applications;
+	BzardRingBuffer<TextT> titles;
+	BzardRingBuffer<BodyT> bodies;
+	BzardRingBuffer<StringIdT> iconUrls;
+	BzardRingBuffer<SlotT> logSlots;
+	BzardRingBuffer<SerialT> serials;
+	BzardRingBuffer<qint64> timestamps;
+
+	BzardBodyCodec codec;
+	mutable QCache<SerialT, QString> unpackedBodies{UNPACKED_BODIES};
+	qint64 packedBytes{0};
+	qint64 packedTextBytes{0};
+
+	BodyT makeBody(const QString &TEXT);
+	void release(size_t index);
+	void compactTexts();
+	static qint64 storedBytes(const BodyT &BODY);
+};
@@ -0,0 +1,137 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_icon_cache.h"
+
+#include <QLoggingCategory>
+#include <QQuickWindow>
+
+#include <qt6xdg/XdgDirs>
+
+Q_LOGGING_CATEGORY(icon_cache, "bzard.icon.cache", QtWarningMsg)
+
+namespace {
+// Paths are hex encoded, so no URL decoding can alter them
+constexpr auto FILE_PREFIX = "file-";
+} // namespace
+
+BzardIconCache::BzardIconCache()
+	  : QQuickImageProvider{QQuickImageProvider::Texture} {}
+
+QString BzardIconCache::fileNameForHash(uintmax_t hash) {
+	return XdgDirs::cacheHome() + "/bzard-cached_" + QString::number(hash) +
+	       ".png";
+}
+
+QString BzardIconCache::urlForHash(uintmax_t hash) {
+	return QStringLiteral("image://") + PROVIDER_ID + '/' +
+	       QString::number(hash);
+}
+
+QString BzardIconCache::urlForFile(const QString &FILE_NAME) {
+	return QStringLiteral("image://") + PROVIDER_ID + '/' + FILE_PREFIX +
+	       QString::fromLatin1(FILE_NAME.toUtf8().toHex());
+}
+
+QQuickTextureFactory *
+BzardIconCache::requestTexture(const QString &id, QSize *size,
+                               const QSize &requestedSize) {
+	auto image = sharedImage(id, requestedSize);
+	if (size)
+		*size = image.size();
+	if (image.isNull())
+		return nullptr;
+	return new BzardIconTextureFactory{image};
+}
+
+int BzardIconCache::uniqueIcons() const {
+	QMutexLocker lock{&mutex};
+	return static_cast<int>(images.size());
+}
+
+qsizetype BzardIconCache::byteCount() const {
+	QMutexLocker lock{&mutex};
+	qsizetype result{0};
+	for (const auto &IMAGE : images)
+		result += IMAGE.sizeInBytes();
+	return result;
+}
+
+QImage BzardIconCache::sharedImage(const QString &id,
+                                   const QSize &requestedSize) {
+	// Popups request icons with the same sourceSize, so key by both
+	auto key = id + '@' + QString::number(requestedSize.width()) + 'x' +
+	           QString::number(requestedSize.height());
+
+	QMutexLocker lock{&mutex};
+	auto cached = images.constFind(key);
+	if (cached != images.cend())
+		return *cached;
+
+	QString fileName;
+	if (id.startsWith(FILE_PREFIX)) {
+		auto hex = QStringView{id}.mid(qstrlen(FILE_PREFIX)).toLatin1();
+		fileName = QString::fromUtf8(QByteArray::fromHex(hex));
+	} else {
+		bool ok{false};
+		auto hash = static_cast<uintmax_t>(id.toULongLong(&ok));
+		if (!ok)
+			return {};
+		fileName = fileNameForHash(hash);
+	}
+
+	QImage image{fileName};
+	if (image.isNull())
+		return {};
+	if (requestedSize.isValid() && image.size() != requestedSize)
+		image = image.scaled(requestedSize, Qt::KeepAspectRatio,
+		                     Qt::SmoothTransformation);
+	image.convertTo(QImage::Format_ARGB32_Premultiplied);
+
+	dropIdleImages();
+	images.insert(key, image);
+	qCDebug(icon_cache) << images.size() << "unique icons";
+	return image;
+}
+
+void BzardIconCache::dropIdleImages() {
+	if (images.size() < MAX_IDLE_ICONS)
+		return;
+
+	// Detached means no live texture factory shares the pixels any more
+	for (auto it = images.begin(); it != images.end();) {
+		if (it->isDetached())
+			it = images.erase(it);
+		else
+			++it;
+	}
+}
+
+BzardIconTextureFactory::BzardIconTextureFactory(const QImage &image)
+	  : image_{image} {}
+
+QSGTexture *BzardIconTextureFactory::createTexture(QQuickWindow *window) const {
+	return window->createTextureFromImage(image_);
+}
+
+QSize BzardIconTextureFactory::textureSize() const { return image_.size(); }
+
+int BzardIconTextureFactory::textureByteCount() const {
+	return static_cast<int>(image_.sizeInBytes());
+}
+
+QImage BzardIconTextureFactory::image() const { return image_; }
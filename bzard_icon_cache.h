@@ -0,0 +1,73 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QQuickImageProvider>
+#include <QSize>
+#include <QString>
+
+/*
+ * Icons resolved by IconHandler are cached on disk under their cache hash and
+ * served to QML as image://bzard-icon/<hash>. All live popups showing the same
+ * icon share one decoded image, so icon memory is paid once per unique icon
+ * instead of once per popup.
+ */
+class BzardIconCache final : public QQuickImageProvider {
+  public:
+	static constexpr auto PROVIDER_ID = "bzard-icon";
+
+	BzardIconCache();
+
+	static QString fileNameForHash(uintmax_t hash);
+	static QString urlForHash(uintmax_t hash);
+	// Local icon files are shared the same way as cached ones
+	static QString urlForFile(const QString &FILE_NAME);
+
+	QQuickTextureFactory *requestTexture(const QString &id, QSize *size,
+	                                     const QSize &requestedSize) final;
+
+	int uniqueIcons() const;
+	qsizetype byteCount() const;
+
+  private:
+	// Unreferenced icons kept around for the next popup of the same app
+	static constexpr auto MAX_IDLE_ICONS = 32;
+
+	mutable QMutex mutex;
+	QHash<QString, QImage> images;
+
+	QImage sharedImage(const QString &id, const QSize &requestedSize);
+	void dropIdleImages();
+};
+
+class BzardIconTextureFactory final : public QQuickTextureFactory {
+	Q_OBJECT
+  public:
+	explicit BzardIconTextureFactory(const QImage &image);
+
+	QSGTexture *createTexture(QQuickWindow *window) const final;
+	QSize textureSize() const final;
+	int textureByteCount() const final;
+	QImage image() const final;
+
+  private:
+	const QImage image_;
+};
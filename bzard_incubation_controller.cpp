@@ -0,0 +1,63 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_incubation_controller.h"
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QLoggingCategory>
+#include <QScreen>
+
+Q_LOGGING_CATEGORY(popup_timing, "bzard.popup.timing", QtWarningMsg)
+
+BzardIncubationController::BzardIncubationController(QObject *parent)
+	  : QObject(parent),
+		BzardConfigurable{"popup_notifications"},
+		budget{qMax(1, config.value(CONFIG_INCUBATION_BUDGET,
+	                                CONFIG_INCUBATION_BUDGET_DEFAULT)
+	                          .toInt())} {
+	auto screen = QGuiApplication::primaryScreen();
+	auto refreshRate = screen ? screen->refreshRate() : 60.;
+	frameTimer.setTimerType(Qt::PreciseTimer);
+	frameTimer.setInterval(static_cast<int>(1000. / qMax(refreshRate, 1.)));
+	connect(&frameTimer, &QTimer::timeout, this,
+	        &BzardIncubationController::incubateSlice);
+}
+
+void BzardIncubationController::incubatingObjectCountChanged(int count) {
+	if (count && !frameTimer.isActive()) {
+		longestSlice = 0;
+		slices = 0;
+		// The first slice need not wait for a frame
+		QTimer::singleShot(0, this, &BzardIncubationController::incubateSlice);
+		frameTimer.start();
+	} else if (!count && frameTimer.isActive()) {
+		frameTimer.stop();
+		qCDebug(popup_timing) << "incubation burst took" << slices
+		                      << "slices, longest" << longestSlice << "ms";
+	}
+}
+
+void BzardIncubationController::incubateSlice() {
+	if (!incubatingObjectCount())
+		return;
+	QElapsedTimer elapsed;
+	elapsed.start();
+	incubateFor(budget);
+	longestSlice = qMax(longestSlice, elapsed.elapsed());
+	++slices;
+}
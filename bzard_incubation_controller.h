@@ -0,0 +1,52 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QQmlIncubationController>
+#include <QTimer>
+
+#include "bzard_config.h"
+
+/*
+ * Runs asynchronous QML incubation in slices of at most the configured
+ * budget, one slice per display frame, so creating a burst of popups
+ * never takes a whole frame away from running animations.
+ */
+class BzardIncubationController final : public QObject,
+                                        public QQmlIncubationController,
+                                        public BzardConfigurable {
+	Q_OBJECT
+
+  public:
+	explicit BzardIncubationController(QObject *parent = nullptr);
+
+  protected:
+	void incubatingObjectCountChanged(int count) final;
+
+  private:
+	BZARD_CONFIG_VAR(INCUBATION_BUDGET, "incubation_budget", 4)
+
+	QTimer frameTimer;
+	int budget;
+	// Worst slice and slice count of the current burst, for the timing log
+	qint64 longestSlice{0};
+	int slices{0};
+
+	void incubateSlice();
+};
@@ -0,0 +1,89 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_input_mask.h"
+
+#include <QQuickWindow>
+#include <QRegion>
+
+BzardInputMask::BzardInputMask(QObject *parent) : QObject(parent) {
+	updateTimer.setSingleShot(true);
+	updateTimer.setInterval(0);
+	connect(&updateTimer, &QTimer::timeout, this, &BzardInputMask::update);
+}
+
+QQuickItem *BzardInputMask::layer() const {
+	return layerItem;
+}
+
+void BzardInputMask::setLayer(QQuickItem *layer) {
+	if (layerItem == layer)
+		return;
+	if (layerItem)
+		disconnect(layerItem, nullptr, this, nullptr);
+	layerItem = layer;
+	if (layerItem) {
+		connect(layerItem, &QQuickItem::childrenChanged, this,
+		        &BzardInputMask::track);
+		connect(layerItem, &QQuickItem::windowChanged, this,
+		        &BzardInputMask::scheduleUpdate);
+		track();
+	}
+	emit layerChanged();
+}
+
+bool BzardInputMask::active() const {
+	return isActive;
+}
+
+void BzardInputMask::track() {
+	for (auto child : layerItem->childItems()) {
+		for (auto changed :
+		     {&QQuickItem::xChanged, &QQuickItem::yChanged,
+		      &QQuickItem::widthChanged, &QQuickItem::heightChanged,
+		      &QQuickItem::visibleChanged})
+			connect(child, changed, this, &BzardInputMask::scheduleUpdate,
+			        Qt::UniqueConnection);
+	}
+	scheduleUpdate();
+}
+
+void BzardInputMask::scheduleUpdate() {
+	if (!updateTimer.isActive())
+		updateTimer.start();
+}
+
+void BzardInputMask::update() {
+	if (!layerItem)
+		return;
+
+	QRegion region;
+	for (auto child : layerItem->childItems())
+		if (child->isVisible())
+			region += child->mapRectToScene(child->boundingRect())
+			                .toAlignedRect();
+
+	/* An empty mask means no mask at all, so an idle overlay relies on
+	 * being hidden through active instead */
+	if (auto window = layerItem->window(); window && !region.isEmpty())
+		window->setMask(region);
+
+	if (isActive != !region.isEmpty()) {
+		isActive = !region.isEmpty();
+		emit activeChanged();
+	}
+}
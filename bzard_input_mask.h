@@ -0,0 +1,60 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QTimer>
+
+/*
+ * Keeps the mask of the window holding a layer item equal to the union of
+ * the layer's visible children, so clicks outside of popups fall through
+ * the overlay. Geometry changes are coalesced into one update per event
+ * loop pass.
+ */
+class BzardInputMask : public QObject {
+	Q_OBJECT
+	QML_ELEMENT
+
+	Q_PROPERTY(QQuickItem *layer READ layer WRITE setLayer NOTIFY layerChanged)
+	Q_PROPERTY(bool active READ active NOTIFY activeChanged)
+  public:
+	explicit BzardInputMask(QObject *parent = nullptr);
+
+	QQuickItem *layer() const;
+	void setLayer(QQuickItem *layer);
+
+	// True while any child of the layer is visible
+	bool active() const;
+
+  signals:
+	void layerChanged();
+	void activeChanged();
+
+  private slots:
+	void track();
+	void scheduleUpdate();
+	void update();
+
+  private:
+	QPointer<QQuickItem> layerItem;
+	QTimer updateTimer;
+	bool isActive{false};
+};
@@ -17,6 +17,8 @@
 
 #include "bzard_notification_modifiers.h"
 
+#include "bzard_icon_cache.h"
+
 #include <map>
 
 #include <QDBusArgument>
@@ -24,7 +26,6 @@
 #include <QIcon>
 #include <QUrl>
 
-#include <qt6xdg/XdgDirs>
 #include <qt6xdg/XdgIcon>
 
 /*
@@ -62,12 +63,6 @@ bool isCached(uintmax_t hash) {
 	return cachedImages.find(hash) != cachedImages.end();
 }
 
-QString imageFilenameFromHash(uintmax_t hash) {
-	auto result = XdgDirs::cacheHome() + "/bzard-cached_" +
-	              QString::number(hash) + ".png";
-	return result;
-}
-
 /*
  * No ret due to we want to reuse var
  */
@@ -78,10 +73,13 @@ void toQmlAbsolutePath(QString &path) {
 		path.insert(0, "file://");
 }
 
+/*
+ * Cached icons are handed to QML through BzardIconCache, so popups showing
+ * the same icon share one decoded image
+ */
 template <class T> bool cacheImage(const T &img, uintmax_t hash) {
-	auto fileName = imageFilenameFromHash(hash);
-	if (img.save(fileName))
-		cachedImages[hash] = std::move(fileName);
+	if (img.save(BzardIconCache::fileNameForHash(hash)))
+		cachedImages[hash] = BzardIconCache::urlForHash(hash);
 	else
 		return false;
 	return true;
@@ -127,8 +125,9 @@ QString getImageUrlFromString(const QString &str) {
 	static constexpr auto PIXEL_MAP_SIZE = 256;
 
 	QUrl url(str);
-	if (url.isValid() && QFile::exists(url.toLocalFile())) {
-		return url.toLocalFile();
+	auto fileName = url.isLocalFile() ? url.toLocalFile() : str;
+	if (fileName.startsWith('/') && QFile::exists(fileName)) {
+		return BzardIconCache::urlForFile(fileName);
 	} else {
 		auto icon = XdgIcon::fromTheme(str);
 		auto hash = static_cast<uintmax_t>(icon.cacheKey());
@@ -42,11 +42,35 @@ BzardNotifications::BzardNotifications(BzardDisposition::PtrT disposition_,
 
 	connect(this, &BzardNotifications::dropNotification, disposition.get(),
 	        &BzardDisposition::remove);
-	connect(disposition.get(), &BzardDisposition::moveNotification,
-	        [this](BzardNotification::IdT id, QPoint position) {
-				emit moveNotification(static_cast<int>(id), position);
+	connect(this, &BzardNotifications::dropNotification, [this](int id) {
+		popupModel.drop(static_cast<BzardNotification::IdT>(id));
+		expirations_.remove(static_cast<BzardNotification::IdT>(id));
+	});
+	// Dropped in one pass, so the disposition reflows once for the batch
+	connect(&expirations_, &BzardExpirations::expired,
+	        [this](const QList<BzardNotification::IdT> &IDS) {
+				for (auto id : IDS)
+					onExpired(static_cast<int>(id));
+			});
+	connect(disposition.get(), &BzardDisposition::reflowed,
+	        [this](const BzardDisposition::MovesT &MOVES) {
+				// Applied in one pass, so the batch animates together
+				for (auto move = MOVES.cbegin(); move != MOVES.cend(); ++move)
+					popupModel.move(move.key(), move.value());
+				// Freed space is filled once per reflow
 				checkExtraNotifications();
 			});
+	connect(disposition.get(), &BzardDisposition::overflowed,
+	        [this](BzardNotification::IdT id) {
+				if (popupModel.notification(id)) {
+					requeue(id);
+					return;
+				}
+				emit dropNotification(static_cast<int>(id));
+				using Reason = BzardNotification::ClosingReason;
+				emit notificationDroppedSignal(
+					  id, Reason::CR_NOTIFICATION_CLOSED_REASON_UNDEFINED);
+			});
 }
 
 BzardNotifications *
@@ -63,6 +87,15 @@ BzardNotifications::get(BzardDisposition::PtrT disposition) {
 	return ptr_;
 }
 
+BzardNotifications *BzardNotifications::create(QQmlEngine *engine,
+                                               QJSEngine *scriptEngine) {
+	Q_UNUSED(engine);
+	Q_UNUSED(scriptEngine);
+	// Created by get() before the engine, which must not delete it
+	QJSEngine::setObjectOwnership(get(), QJSEngine::CppOwnership);
+	return get();
+}
+
 void BzardNotifications::setFullscreenDetector(
 	  std::unique_ptr<BzardFullscreenDetector> detector) {
 	fullscreenDetector = std::move(detector);
@@ -99,6 +132,29 @@ bool BzardNotifications::dontShowWhenFullscreenAny() const {
 	      .toBool();
 }
 
+bool BzardNotifications::variableHeight() const {
+	return disposition->variableHeight();
+}
+
+int BzardNotifications::popupPoolSize() const {
+	return qMax(0, config.value(CONFIG_POPUP_POOL_SIZE,
+	                            CONFIG_POPUP_POOL_SIZE_DEFAULT)
+	                     .toInt());
+}
+
+bool BzardNotifications::singleOverlay() const {
+	return config.value(CONFIG_SINGLE_OVERLAY, CONFIG_SINGLE_OVERLAY_DEFAULT)
+	      .toBool();
+}
+
+QAbstractItemModel *BzardNotifications::popups() {
+	return &popupModel;
+}
+
+BzardExpirations *BzardNotifications::expirations() {
+	return &expirations_;
+}
+
 bool BzardNotifications::dontShowWhenFullscreenCurrentDesktop() const {
 	return config
 	      .value(CONFIG_DONT_SHOW_WHEN_FULLSCREEN_CURRENT_DESKTOP,
@@ -113,10 +169,14 @@ void BzardNotifications::setDontShowWhenFullscreenCurrentDesktop(bool value) {
 
 void BzardNotifications::onCreateNotification(
 	  const BzardNotification &NOTIFICATION) {
+	// Replacements of live popups are applied to them in place
+	if (NOTIFICATION.replacesId &&
+	    popupModel.update(NOTIFICATION.replacesId, NOTIFICATION))
+		return;
 	if (!shouldShowPopup())
 		return;
 	if (!createNotificationIfSpaceAvailable(NOTIFICATION)) {
-		extraNotifications.push(NOTIFICATION);
+		extraNotifications.push_back(NOTIFICATION);
 		emit extraNotificationsCountChanged();
 	}
 }
@@ -132,7 +192,6 @@ void BzardNotifications::onCloseButtonPressed(int id) {
 	emit notificationDroppedSignal(
 		  static_cast<BzardNotification::IdT>(id),
 		  BzardNotification::CR_NOTIFICATION_DISMISSED);
-	checkExtraNotifications();
 }
 
 void BzardNotifications::onActionButtonPressed(int id, const QString &action) {
@@ -149,6 +208,15 @@ void BzardNotifications::onExpired(int id) {
 	                               BzardNotification::CR_NOTIFICATION_EXPIRED);
 }
 
+void BzardNotifications::onNotificationResized(int id, int height) {
+	measuredHeight = height;
+	disposition->resize(static_cast<BzardNotification::IdT>(id), height);
+}
+
+void BzardNotifications::onPopupReleased(int id) {
+	popupModel.remove(static_cast<BzardNotification::IdT>(id));
+}
+
 void BzardNotifications::onDropAll() {
 	onDropStacked();
 	onDropVisible();
@@ -161,7 +229,7 @@ void BzardNotifications::onDropStacked() {
 }
 
 void BzardNotifications::onDropVisible() {
-	emit dropAllVisible();
+	popupModel.dropAll();
 	disposition->removeAll();
 	checkExtraNotifications();
 }
@@ -246,14 +314,16 @@ QSize BzardNotifications::autoWindowSize(double widthFactor,
 bool BzardNotifications::createNotificationIfSpaceAvailable(
 	  const BzardNotification &notification) {
 	auto size = windowSize();
-	auto position = disposition->poses(notification.id, size);
+	// Popups fit their content: place at the last measured height and let
+	// resize() correct it once this one is measured
+	auto placed = size;
+	if (variableHeight() && measuredHeight > 0)
+		placed.setHeight(qMin(measuredHeight, size.height()));
+	auto position = disposition->poses(notification.id, placed);
 	if (position) {
 		auto id = notification.replacesId ? notification.replacesId
 		                                  : notification.id;
-		emit createNotification(
-			  static_cast<int>(id), size, *position, notification.expireTimeout,
-			  notification.application, notification.body, notification.title,
-			  notification.iconUrl, notification.actions);
+		popupModel.add(id, notification, size, *position);
 		return true;
 	} else {
 		return false;
@@ -261,13 +331,29 @@ bool BzardNotifications::createNotificationIfSpaceAvailable(
 }
 
 void BzardNotifications::checkExtraNotifications() {
-	while (!extraNotifications.empty() &&
-	       createNotificationIfSpaceAvailable(extraNotifications.front())) {
-		extraNotifications.pop();
+	while (!extraNotifications.empty()) {
+		// Taken out first: placing may requeue popups at the front
+		auto notification = std::move(extraNotifications.front());
+		extraNotifications.pop_front();
+		if (!createNotificationIfSpaceAvailable(notification)) {
+			extraNotifications.push_front(std::move(notification));
+			break;
+		}
 		emit extraNotificationsCountChanged();
 	}
 }
 
+/*
+ * A popup grew past the screen once measured, or the screen shrank: it
+ * goes back to the front of the queue instead of being closed.
+ */
+void BzardNotifications::requeue(BzardNotification::IdT id) {
+	extraNotifications.push_front(*popupModel.notification(id));
+	popupModel.drop(id);
+	expirations_.remove(id);
+	emit extraNotificationsCountChanged();
+}
+
 bool BzardNotifications::shouldShowPopup() const {
 	if (fullscreenDetector) {
 		if (dontShowWhenFullscreenCurrentDesktop()) {
@@ -17,10 +17,11 @@
 
 #pragma once
 
-#include <queue>
+#include <deque>
 
 #include <QObject>
 #include <QPoint>
+#include <QQmlEngine>
 #include <QSize>
 
 #pragma clang diagnostic push
@@ -29,12 +30,16 @@
 
 #include "bzard_config.h"
 #include "bzard_disposition.h"
+#include "bzard_expirations.h"
 #include "bzard_fullscreen_detector.h"
 #include "bzard_notification_receiver.h"
+#include "bzard_popup_model.h"
 
 class BzardNotifications final : public BzardNotificationReceiver,
 								 public BzardConfigurable {
 	Q_OBJECT
+	QML_ELEMENT
+	QML_SINGLETON
 	Q_PROPERTY(int extraNotifications READ extraNotificationsCount NOTIFY
 	                 extraNotificationsCountChanged)
 	Q_PROPERTY(QSize extraWindowSize READ extraWindowSize CONSTANT)
@@ -45,6 +50,10 @@ class BzardNotifications final : public BzardNotificationReceiver,
 	Q_PROPERTY(bool closeByLeftClick READ closeByLeftClick CONSTANT)
 	Q_PROPERTY(bool dontShowWhenFullscreenAny READ dontShowWhenFullscreenAny
 	                 CONSTANT)
+	Q_PROPERTY(bool variableHeight READ variableHeight CONSTANT)
+	Q_PROPERTY(int popupPoolSize READ popupPoolSize CONSTANT)
+	Q_PROPERTY(bool singleOverlay READ singleOverlay CONSTANT)
+	Q_PROPERTY(QAbstractItemModel *popups READ popups CONSTANT)
 
 	/*
 	 * Changable on-the-fly
@@ -60,6 +69,8 @@ class BzardNotifications final : public BzardNotificationReceiver,
   public:
 	static BzardNotifications *
 	get(BzardDisposition::PtrT disposition = nullptr);
+	static BzardNotifications *create(QQmlEngine *engine,
+	                                  QJSEngine *scriptEngine);
 
 	void
 	setFullscreenDetector(std::unique_ptr<BzardFullscreenDetector> detector_);
@@ -71,6 +82,11 @@ class BzardNotifications final : public BzardNotificationReceiver,
 	bool closeVisibleByLeftClick() const;
 	bool closeByLeftClick() const;
 	bool dontShowWhenFullscreenAny() const;
+	bool variableHeight() const;
+	int popupPoolSize() const;
+	bool singleOverlay() const;
+	QAbstractItemModel *popups();
+	BzardExpirations *expirations();
 
 	bool dontShowWhenFullscreenCurrentDesktop() const;
 	void setDontShowWhenFullscreenCurrentDesktop(bool value);
@@ -78,15 +94,7 @@ class BzardNotifications final : public BzardNotificationReceiver,
   signals:
 	// Signals to QML
 	void extraNotificationsCountChanged();
-	void createNotification(int notificationId, QSize size, QPoint position,
-	                        int expireTimeout, const QString &APP_NAME,
-	                        const QString &BODY,
-	                        const QString &TITLE = QString{},
-	                        const QString &ICON_URL = QString{},
-	                        const QStringList &ACTIONS = {});
 	void dropNotification(int notificatioId);
-	void dropAllVisible();
-	void moveNotification(int notificationId, QPoint position);
 
 	/*
 	 * Property changed signals
@@ -101,6 +109,8 @@ class BzardNotifications final : public BzardNotificationReceiver,
 	void onCloseButtonPressed(int id);
 	void onActionButtonPressed(int id, const QString &ACTION);
 	void onExpired(int id);
+	void onNotificationResized(int id, int height);
+	void onPopupReleased(int id);
 	void onDropAll();
 	void onDropStacked();
 	void onDropVisible();
@@ -111,6 +121,8 @@ class BzardNotifications final : public BzardNotificationReceiver,
 	                 "close_visible_by_middle_click", true)
 	BZARD_CONFIG_VAR(CLOSE_BY_LEFT_CLICK, "close_by_left_click", false)
 	BZARD_CONFIG_VAR(SPACING, "spacing", 0)
+	BZARD_CONFIG_VAR(POPUP_POOL_SIZE, "popup_pool_size", 4)
+	BZARD_CONFIG_VAR(SINGLE_OVERLAY, "single_overlay", false)
 	BZARD_CONFIG_FACTOR(GLOBAL_MARGINS, "global_margins",
 	                    0.02610966057441253264)
 	BZARD_CONFIG_VAR(DONT_SHOW_WHEN_FULLSCREEN_ANY,
@@ -123,8 +135,12 @@ class BzardNotifications final : public BzardNotificationReceiver,
 	                 "dont_show_when_fullscreen_current_desktop", false)
 
 	BzardDisposition::PtrT disposition;
-	std::queue<BzardNotification> extraNotifications;
+	std::deque<BzardNotification> extraNotifications;
 	std::unique_ptr<BzardFullscreenDetector> fullscreenDetector;
+	BzardPopupModel popupModel;
+	BzardExpirations expirations_;
+	// Last height a popup was measured at, new popups are placed with it
+	int measuredHeight{0};
 
 	static constexpr double WIDTH_DEFAULT_FACTOR = 0.21961932650073206442;
 	static constexpr double HEIGHT_DEFAULT_FACTOR = 0.28198433420365535248;
@@ -140,5 +156,6 @@ class BzardNotifications final : public BzardNotificationReceiver,
 	bool
 	createNotificationIfSpaceAvailable(const BzardNotification &notification);
 	void checkExtraNotifications();
+	void requeue(BzardNotification::IdT id);
 	bool shouldShowPopup() const;
 };
@@ -0,0 +1,182 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_popup_model.h"
+
+#include <QVariantMap>
+
+namespace {
+
+size_t content_hash(const BzardNotification &NOTIFICATION) {
+	return qHashMulti(0, NOTIFICATION.application, NOTIFICATION.title,
+	                  NOTIFICATION.body, NOTIFICATION.iconUrl,
+	                  NOTIFICATION.actions,
+	                  static_cast<int>(NOTIFICATION.expireTimeout));
+}
+
+// Actions come as key and text pairs
+QVariantList actions_to_buttons(const QStringList &ACTIONS) {
+	QVariantList buttons;
+	buttons.reserve(ACTIONS.size() / 2);
+	for (qsizetype i = 0; i + 1 < ACTIONS.size(); i += 2)
+		buttons.append(
+			  QVariantMap{{"action", ACTIONS[i]}, {"text", ACTIONS[i + 1]}});
+	return buttons;
+}
+
+} // namespace
+
+int BzardPopupModel::rowCount(const QModelIndex &parent) const {
+	if (parent.isValid())
+		return 0;
+	return static_cast<int>(popups.size());
+}
+
+QVariant BzardPopupModel::data(const QModelIndex &index, int role) const {
+	if (!index.isValid() || index.row() >= rowCount())
+		return {};
+
+	const auto &POPUP = popups[static_cast<size_t>(index.row())];
+	switch (role) {
+	case PR_ID_ROLE:
+		return static_cast<int>(POPUP.id);
+	case PR_SIZE_ROLE:
+		return POPUP.size;
+	case PR_POSITION_ROLE:
+		return POPUP.position;
+	case PR_EXPIRE_TIMEOUT_ROLE:
+		return static_cast<int>(POPUP.notification.expireTimeout);
+	case PR_APPLICATION_ROLE:
+		return POPUP.notification.application;
+	case PR_TITLE_ROLE:
+		return POPUP.notification.title;
+	case PR_BODY_ROLE:
+		return POPUP.notification.body;
+	case PR_ICON_URL_ROLE:
+		return POPUP.notification.iconUrl;
+	case PR_BUTTONS_ROLE:
+		return actions_to_buttons(POPUP.notification.actions);
+	case PR_ALIVE_ROLE:
+		return POPUP.alive;
+	case PR_REVISION_ROLE:
+		return POPUP.revision;
+	default:
+		break;
+	}
+	return {};
+}
+
+QHash<int, QByteArray> BzardPopupModel::roleNames() const {
+	QHash<int, QByteArray> roles;
+	roles[PR_ID_ROLE] = "notificationId";
+	roles[PR_SIZE_ROLE] = "size";
+	roles[PR_POSITION_ROLE] = "position";
+	roles[PR_EXPIRE_TIMEOUT_ROLE] = "expireTimeout";
+	roles[PR_APPLICATION_ROLE] = "appName";
+	roles[PR_TITLE_ROLE] = "title";
+	roles[PR_BODY_ROLE] = "body";
+	roles[PR_ICON_URL_ROLE] = "iconUrl";
+	roles[PR_BUTTONS_ROLE] = "buttons";
+	roles[PR_ALIVE_ROLE] = "alive";
+	roles[PR_REVISION_ROLE] = "revision";
+	return roles;
+}
+
+void BzardPopupModel::add(IdT id, const BzardNotification &NOTIFICATION,
+                          QSize size, QPoint position) {
+	// A popup of the same id may still be dropping
+	remove(id);
+
+	auto row = rowCount();
+	beginInsertRows({}, row, row);
+	popups.push_back({id, NOTIFICATION, size, position,
+	                  content_hash(NOTIFICATION), true, 0});
+	rows.insert(id, row);
+	endInsertRows();
+}
+
+bool BzardPopupModel::update(IdT id, const BzardNotification &NOTIFICATION) {
+	auto row = rowOf(id);
+	if (row < 0 || !popups[static_cast<size_t>(row)].alive)
+		return false;
+
+	auto &popup = popups[static_cast<size_t>(row)];
+	// Progress ticks often repeat the same content
+	auto hash = content_hash(NOTIFICATION);
+	if (popup.hash == hash)
+		return true;
+	popup.notification = NOTIFICATION;
+	popup.hash = hash;
+	++popup.revision;
+	changed(row, {PR_EXPIRE_TIMEOUT_ROLE, PR_APPLICATION_ROLE, PR_TITLE_ROLE,
+	              PR_BODY_ROLE, PR_ICON_URL_ROLE, PR_BUTTONS_ROLE,
+	              PR_REVISION_ROLE});
+	return true;
+}
+
+void BzardPopupModel::move(IdT id, QPoint position) {
+	auto row = rowOf(id);
+	if (row < 0)
+		return;
+	popups[static_cast<size_t>(row)].position = position;
+	changed(row, {PR_POSITION_ROLE});
+}
+
+const BzardNotification *BzardPopupModel::notification(IdT id) const {
+	auto row = rowOf(id);
+	if (row < 0 || !popups[static_cast<size_t>(row)].alive)
+		return nullptr;
+	return &popups[static_cast<size_t>(row)].notification;
+}
+
+void BzardPopupModel::drop(IdT id) {
+	auto row = rowOf(id);
+	if (row < 0 || !popups[static_cast<size_t>(row)].alive)
+		return;
+	popups[static_cast<size_t>(row)].alive = false;
+	changed(row, {PR_ALIVE_ROLE});
+}
+
+void BzardPopupModel::dropAll() {
+	if (popups.empty())
+		return;
+	for (auto &popup : popups)
+		popup.alive = false;
+	emit dataChanged(index(0), index(rowCount() - 1), {PR_ALIVE_ROLE});
+}
+
+void BzardPopupModel::remove(IdT id) {
+	auto row = rowOf(id);
+	if (row < 0)
+		return;
+
+	beginRemoveRows({}, row, row);
+	popups.erase(popups.begin() + row);
+	rows.remove(id);
+	for (auto i = static_cast<size_t>(row); i < popups.size(); ++i)
+		rows[popups[i].id] = static_cast<int>(i);
+	endRemoveRows();
+}
+
+int BzardPopupModel::rowOf(IdT id) const {
+	return rows.value(id, -1);
+}
+
+void BzardPopupModel::changed(int row, const QList<int> &ROLES) {
+	auto cell = index(row);
+	emit dataChanged(cell, cell, ROLES);
+}
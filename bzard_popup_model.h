@@ -0,0 +1,91 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QPoint>
+#include <QSize>
+
+#include "bzard_notification.h"
+
+/*
+ * Notifications shown in popups, one row each. Rows stay while the popup
+ * plays its drop animation with alive set to false, and leave once QML
+ * releases the popup. Rows are found by id in O(1).
+ */
+class BzardPopupModel : public QAbstractListModel {
+	Q_OBJECT
+
+  public:
+	using IdT = BzardNotification::IdT;
+
+	enum PopupRoles {
+		PR_ID_ROLE = Qt::UserRole + 1,
+		PR_SIZE_ROLE,
+		PR_POSITION_ROLE,
+		PR_EXPIRE_TIMEOUT_ROLE,
+		PR_APPLICATION_ROLE,
+		PR_TITLE_ROLE,
+		PR_BODY_ROLE,
+		PR_ICON_URL_ROLE,
+		PR_BUTTONS_ROLE,
+		PR_ALIVE_ROLE,
+		PR_REVISION_ROLE
+	};
+
+	using QAbstractListModel::QAbstractListModel;
+
+	int rowCount(const QModelIndex &parent = {}) const final;
+	QVariant data(const QModelIndex &index, int role) const final;
+	QHash<int, QByteArray> roleNames() const final;
+
+	void add(IdT id, const BzardNotification &NOTIFICATION, QSize size,
+	         QPoint position);
+	/*
+	 * Replaces the content of a live popup. False if there is none, a no-op
+	 * if the content is the same.
+	 */
+	bool update(IdT id, const BzardNotification &NOTIFICATION);
+	// Notification of the live popup, nullptr if there is none
+	const BzardNotification *notification(IdT id) const;
+	void move(IdT id, QPoint position);
+	void drop(IdT id);
+	void dropAll();
+	void remove(IdT id);
+
+  private:
+	struct Popup {
+		IdT id;
+		BzardNotification notification;
+		QSize size;
+		QPoint position;
+		size_t hash;
+		bool alive;
+		// Bumped on every update, so QML restarts the expiration
+		int revision;
+	};
+
+	std::vector<Popup> popups;
+	QHash<IdT, int> rows;
+
+	int rowOf(IdT id) const;
+	void changed(int row, const QList<int> &ROLES);
+};
@@ -0,0 +1,100 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*
+ * Fixed-capacity ring buffer ordered newest first: index 0 is the element
+ * pushed last. Pushing and dropping from either end never reallocates.
+ */
+template <class ValueType> class BzardRingBuffer {
+  public:
+	explicit BzardRingBuffer(size_t capacity_)
+		  : slots(capacity_ ? capacity_ : 1) {}
+
+	size_t size() const { return count; }
+	size_t capacity() const { return slots.size(); }
+	bool empty() const { return count == 0; }
+	bool full() const { return count == slots.size(); }
+
+	ValueType &operator[](size_t index) { return slots[physical(index)]; }
+	const ValueType &operator[](size_t index) const {
+		return slots[physical(index)];
+	}
+
+	// Caller makes room first: pushing into a full buffer is a bug
+	void pushFront(ValueType value) {
+		head = (head + slots.size() - 1) % slots.size();
+		slots[head] = std::move(value);
+		++count;
+	}
+
+	// Drops the oldest elements
+	void popBack(size_t n = 1) {
+		for (; n && count; --n)
+			slots[physical(--count)] = ValueType{};
+	}
+
+	// Shifts whichever side of the hole is shorter
+	void erase(size_t index) {
+		if (index < count / 2) {
+			for (auto i = index; i > 0; --i)
+				(*this)[i] = std::move((*this)[i - 1]);
+			slots[head] = ValueType{};
+			head = (head + 1) % slots.size();
+			--count;
+		} else {
+			for (auto i = index; i + 1 < count; ++i)
+				(*this)[i] = std::move((*this)[i + 1]);
+			popBack();
+		}
+	}
+
+	// Erases the elements at ascending, unique indexes in one pass
+	void erase(const std::vector<size_t> &INDEXES) {
+		if (INDEXES.size() < 2) {
+			if (!INDEXES.empty())
+				erase(INDEXES.front());
+			return;
+		}
+		auto next = INDEXES.cbegin();
+		auto to = *next;
+		for (auto from = to; from < count; ++from) {
+			if (next != INDEXES.cend() && *next == from) {
+				++next;
+				continue;
+			}
+			(*this)[to++] = std::move((*this)[from]);
+		}
+		popBack(count - to);
+	}
+
+	void clear() { popBack(count); }
+
+  private:
+	std::vector<ValueType> slots;
+	size_t head{0};
+	size_t count{0};
+
+	size_t physical(size_t index) const {
+		return (head + index) % slots.size();
+	}
+};
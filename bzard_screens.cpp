@@ -0,0 +1,192 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_screens.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <QCursor>
+#include <QGuiApplication>
+
+BzardScreens::BzardScreens(MakeT make_, Placement placement_,
+                           QObject *parent)
+	  : BzardDisposition(nullptr, parent), make{std::move(make_)},
+		placement{placement_} {
+	for (auto screen : QGuiApplication::screens())
+		addScreen(screen);
+	connect(qGuiApp, &QGuiApplication::screenAdded, this,
+	        &BzardScreens::addScreen);
+	connect(qGuiApp, &QGuiApplication::screenRemoved, this,
+	        &BzardScreens::removeScreen);
+}
+
+BzardScreens::Optional<QPoint> BzardScreens::poses(BzardNotification::IdT id,
+                                                   QSize size) {
+	// Already here, must be replaced
+	auto found = placed.constFind(id);
+	if (found != placed.cend())
+		return layouts.at(found->screen)->poses(id, size);
+
+	auto screen = targetScreen();
+	// Between the last screen going away and a new one coming
+	if (!screen)
+		return {};
+	auto position = layouts.at(screen)->poses(id, size);
+	if (position)
+		placed.insert(id, {screen, size});
+	return position;
+}
+
+void BzardScreens::resize(BzardNotification::IdT id, int height) {
+	auto found = placed.find(id);
+	if (found == placed.end())
+		return;
+	found->size.setHeight(height);
+	layouts.at(found->screen)->resize(id, height);
+}
+
+bool BzardScreens::variableHeight() const {
+	auto layout = primaryLayout();
+	return layout && layout->variableHeight();
+}
+
+QPoint BzardScreens::externalWindowPosition() const {
+	auto layout = primaryLayout();
+	return layout ? layout->externalWindowPosition() : QPoint{};
+}
+
+const QScreen *BzardScreens::screen() const {
+	return QGuiApplication::primaryScreen();
+}
+
+// The extra notifications window only takes room on the primary screen
+void BzardScreens::setExtraWindowSize(const QSize &value) {
+	BzardDisposition::setExtraWindowSize(value);
+	if (auto layout = primaryLayout())
+		layout->setExtraWindowSize(value);
+}
+
+void BzardScreens::setMargins(const QMargins &value) {
+	BzardDisposition::setMargins(value);
+	for (auto &layout : layouts)
+		layout.second->setMargins(value);
+}
+
+void BzardScreens::setSpacing(int value) {
+	BzardDisposition::setSpacing(value);
+	for (auto &layout : layouts)
+		layout.second->setSpacing(value);
+}
+
+void BzardScreens::remove(BzardNotification::IdT id) {
+	auto found = placed.find(id);
+	if (found == placed.end())
+		return;
+	layouts.at(found->screen)->remove(id);
+	placed.erase(found);
+}
+
+void BzardScreens::removeAll() {
+	for (auto &layout : layouts)
+		layout.second->removeAll();
+	placed.clear();
+}
+
+void BzardScreens::addScreen(QScreen *screen) {
+	auto layout = make(screen);
+	layout->setSpacing(spacing);
+	layout->setMargins(margins);
+	if (screen == QGuiApplication::primaryScreen())
+		layout->setExtraWindowSize(extraWindowSize);
+
+	connect(layout.get(), &BzardDisposition::reflowed, this,
+	        &BzardDisposition::reflowed);
+	connect(layout.get(), &BzardDisposition::overflowed, this,
+	        [this](BzardNotification::IdT id) {
+				placed.remove(id);
+				emit overflowed(id);
+			});
+	layouts[screen] = std::move(layout);
+	// Room for popups queued while there was no screen
+	emit reflowed({});
+}
+
+void BzardScreens::removeScreen(QScreen *screen) {
+	auto found = layouts.find(screen);
+	if (found == layouts.end())
+		return;
+
+	std::vector<BzardNotification::IdT> orphans;
+	for (auto popup = placed.cbegin(); popup != placed.cend(); ++popup)
+		if (popup->screen == screen)
+			orphans.push_back(popup.key());
+	// Ids grow with arrival, so the stack order is kept
+	std::sort(orphans.begin(), orphans.end());
+	layouts.erase(found);
+	// No screen left to take them
+	if (layouts.empty()) {
+		for (auto id : orphans) {
+			placed.remove(id);
+			emit overflowed(id);
+		}
+		return;
+	}
+
+	MovesT moves;
+	auto target = targetScreen();
+	for (auto id : orphans) {
+		auto &popup = placed[id];
+		auto position = layouts.at(target)->poses(id, popup.size);
+		if (position) {
+			popup.screen = target;
+			moves.insert(id, *position);
+		} else {
+			placed.remove(id);
+			emit overflowed(id);
+		}
+	}
+	emit reflowed(moves);
+}
+
+QScreen *BzardScreens::targetScreen() const {
+	QScreen *screen = QGuiApplication::primaryScreen();
+	if (placement == Placement::CURSOR) {
+		auto underCursor = QGuiApplication::screenAt(QCursor::pos());
+		if (underCursor)
+			screen = underCursor;
+	}
+	// Removed screens may still be reported for a moment
+	if (!layouts.count(screen))
+		return layouts.empty() ? nullptr : layouts.begin()->first;
+	return screen;
+}
+
+BzardDisposition *BzardScreens::primaryLayout() const {
+	if (layouts.empty())
+		return nullptr;
+	auto found = layouts.find(QGuiApplication::primaryScreen());
+	if (found == layouts.end())
+		return layouts.begin()->second.get();
+	return found->second.get();
+}
+
+// Every screen keeps its own transaction
+void BzardScreens::reflow() {}
+
+void BzardScreens::relayout() {}
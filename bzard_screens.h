@@ -0,0 +1,83 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+
+#include <QHash>
+#include <QObject>
+#include <QPoint>
+
+#include "bzard_disposition.h"
+
+/*
+ * One disposition per screen, each with its own layout state. New popups
+ * go to the primary screen or to the one under the cursor. A screen
+ * change only touches the layout of that screen; popups on an unplugged
+ * screen are placed again on another one.
+ */
+class BzardScreens final : public BzardDisposition {
+	Q_OBJECT
+
+  public:
+	using BzardDisposition::Optional;
+	enum class Placement { PRIMARY, CURSOR };
+	using MakeT = std::function<BzardDisposition::PtrT(QScreen *)>;
+
+	BzardScreens(MakeT make_, Placement placement_,
+	             QObject *parent = nullptr);
+
+	Optional<QPoint> poses(BzardNotification::IdT id, QSize size) final;
+	void resize(BzardNotification::IdT id, int height) final;
+	bool variableHeight() const final;
+
+	QPoint externalWindowPosition() const final;
+
+	const QScreen *screen() const final;
+
+	void setExtraWindowSize(const QSize &VALUE) final;
+
+	void setMargins(const QMargins &VALUE) final;
+
+	void setSpacing(int value) final;
+
+  public slots:
+	void remove(BzardNotification::IdT id) final;
+	void removeAll() final;
+
+  private:
+	// What a popup needs to be placed again elsewhere
+	struct Placed {
+		QScreen *screen;
+		QSize size;
+	};
+
+	const MakeT make;
+	const Placement placement;
+	std::map<QScreen *, BzardDisposition::PtrT> layouts;
+	QHash<BzardNotification::IdT, Placed> placed;
+
+	void addScreen(QScreen *screen);
+	void removeScreen(QScreen *screen);
+	// Both null while there is no screen at all
+	QScreen *targetScreen() const;
+	BzardDisposition *primaryLayout() const;
+	void reflow() final;
+	void relayout() final;
+};
@@ -0,0 +1,103 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_slot_stack.h"
+
+bool BzardSlotStack::contains(IdT id) const { return slotOf.contains(id); }
+
+bool BzardSlotStack::empty() const { return slotOf.isEmpty(); }
+
+int BzardSlotStack::extent() const { return extents.prefix(slots.size()); }
+
+void BzardSlotStack::push(IdT id, int length) {
+	slotOf.insert(id, slots.size());
+	slots.push_back({id, length, true});
+	extents.pushBack(length + spacing);
+}
+
+bool BzardSlotStack::resize(IdT id, int length) {
+	auto found = slotOf.constFind(id);
+	if (found == slotOf.cend())
+		return false;
+
+	auto &slot = slots[*found];
+	if (slot.length == length)
+		return false;
+	extents.add(*found, length - slot.length);
+	slot.length = length;
+	// The slot itself too: bottom-up, its top moves with its length
+	markDirty(*found);
+	return true;
+}
+
+bool BzardSlotStack::remove(IdT id) {
+	auto found = slotOf.find(id);
+	if (found == slotOf.end())
+		return false;
+
+	auto slot = *found;
+	slotOf.erase(found);
+	slots[slot].live = false;
+	extents.add(slot, -(slots[slot].length + spacing));
+	++dead;
+	markDirty(slot);
+	return true;
+}
+
+void BzardSlotStack::clear() {
+	slots.clear();
+	extents.clear();
+	slotOf.clear();
+	dead = 0;
+	dirtyFrom = NOT_DIRTY;
+}
+
+void BzardSlotStack::setSpacing(int value) {
+	spacing = value;
+	rebuildExtents();
+	markDirty(0);
+}
+
+void BzardSlotStack::invalidate() { markDirty(0); }
+
+void BzardSlotStack::markDirty(size_t slot) {
+	dirtyFrom = qMin(dirtyFrom, slot);
+}
+
+void BzardSlotStack::compact() {
+	size_t kept{0};
+	for (size_t i = 0; i < slots.size(); ++i) {
+		if (!slots[i].live)
+			continue;
+		slotOf[slots[i].id] = kept;
+		slots[kept++] = slots[i];
+	}
+	slots.resize(kept);
+	dead = 0;
+	rebuildExtents();
+	// Offsets stay, dead slots were empty; only the numbering changed
+	if (dirtyFrom != NOT_DIRTY)
+		dirtyFrom = 0;
+}
+
+void BzardSlotStack::rebuildExtents() {
+	std::vector<int> values;
+	values.reserve(slots.size());
+	for (const auto &SLOT : slots)
+		values.push_back(SLOT.live ? SLOT.length + spacing : 0);
+	extents.assign(values);
+}
@@ -0,0 +1,98 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include <QHash>
+
+#include "bzard_fenwick_tree.h"
+#include "bzard_notification.h"
+
+/*
+ * Popups stacked along one axis in arrival order. Every popup owns a slot;
+ * a Fenwick tree over slot extents gives the offset of any slot, so
+ * pushing, resizing and removing cost O(log n). Removed slots are zeroed
+ * and dropped once half of them are dead.
+ */
+class BzardSlotStack {
+  public:
+	using IdT = BzardNotification::IdT;
+
+	bool contains(IdT id) const;
+	bool empty() const;
+	// Offset the next popup would get
+	int extent() const;
+
+	void push(IdT id, int length);
+	// Both return whether anything changed
+	bool resize(IdT id, int length);
+	bool remove(IdT id);
+	void clear();
+	void setSpacing(int value);
+	// Makes the next reflow visit every popup
+	void invalidate();
+
+	/*
+	 * Calls visit(id, offset, length) for every popup that may have moved
+	 * since the last reflow
+	 */
+	template <typename Visit> void reflow(Visit visit);
+
+  private:
+	struct Slot {
+		IdT id;
+		int length;
+		bool live;
+	};
+
+	static constexpr size_t NOT_DIRTY = std::numeric_limits<size_t>::max();
+	static constexpr size_t COMPACT_SLOTS = 32;
+
+	int spacing{0};
+	std::vector<Slot> slots;
+	// Length plus spacing per live slot, 0 for dead ones
+	BzardFenwickTree extents;
+	QHash<IdT, size_t> slotOf;
+	size_t dead{0};
+	// First slot whose offset may have changed
+	size_t dirtyFrom{NOT_DIRTY};
+
+	void markDirty(size_t slot);
+	void compact();
+	void rebuildExtents();
+};
+
+template <typename Visit> void BzardSlotStack::reflow(Visit visit) {
+	if (dead >= COMPACT_SLOTS && dead * 2 >= slots.size())
+		compact();
+	if (dirtyFrom == NOT_DIRTY)
+		return;
+
+	// Only slots after the first change can move
+	auto offset = extents.prefix(dirtyFrom);
+	for (auto slot = dirtyFrom; slot < slots.size(); ++slot) {
+		const auto &SLOT = slots[slot];
+		if (!SLOT.live)
+			continue;
+		visit(SLOT.id, offset, SLOT.length);
+		offset += SLOT.length + spacing;
+	}
+	dirtyFrom = NOT_DIRTY;
+}
@@ -0,0 +1,64 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_string_pool.h"
+
+BzardStringPool::IdT BzardStringPool::intern(const QString &string) {
+	auto found = ids.constFind(string);
+	if (found != ids.cend()) {
+		++entries[*found].references;
+		return *found;
+	}
+
+	IdT id;
+	if (freeIds.empty()) {
+		id = static_cast<IdT>(entries.size());
+		entries.emplace_back();
+	} else {
+		id = freeIds.back();
+		freeIds.pop_back();
+	}
+	entries[id] = {string, 1};
+	ids.insert(string, id);
+	bytes += stringBytes(string);
+	return id;
+}
+
+void BzardStringPool::release(IdT id) {
+	auto &entry = entries[id];
+	if (--entry.references)
+		return;
+
+	bytes -= stringBytes(entry.string);
+	ids.remove(entry.string);
+	entry.string = QString{};
+	freeIds.push_back(id);
+}
+
+const QString &BzardStringPool::string(IdT id) const {
+	return entries[id].string;
+}
+
+size_t BzardStringPool::size() const { return ids.size(); }
+
+qint64 BzardStringPool::byteCount() const {
+	return bytes + static_cast<qint64>(entries.capacity() * sizeof(Entry));
+}
+
+qint64 BzardStringPool::stringBytes(const QString &string) {
+	return string.capacity() * static_cast<qint64>(sizeof(QChar));
+}
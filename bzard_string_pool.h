@@ -0,0 +1,52 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <QHash>
+#include <QString>
+
+/*
+ * Reference-counted string interning. Equal strings share one id and one
+ * copy; a string is dropped when its last reference is released.
+ */
+class BzardStringPool {
+  public:
+	using IdT = quint32;
+
+	IdT intern(const QString &STRING);
+	void release(IdT id);
+
+	const QString &string(IdT id) const;
+	size_t size() const;
+	qint64 byteCount() const;
+
+  private:
+	struct Entry {
+		QString string;
+		quint32 references{0};
+	};
+
+	std::vector<Entry> entries;
+	std::vector<IdT> freeIds;
+	QHash<QString, IdT> ids;
+	qint64 bytes{0};
+
+	static qint64 stringBytes(const QString &STRING);
+};
@@ -0,0 +1,112 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_text_arena.h"
+
+#include <algorithm>
+
+BzardTextArena::Ref BzardTextArena::add(const QString &text) {
+	if (text.isEmpty())
+		return {};
+
+	auto latin1 = std::all_of(text.cbegin(), text.cend(),
+	                          [](QChar c) { return c.unicode() < 0x100; });
+	auto encoded = latin1 ? text.toLatin1() : text.toUtf8();
+	return append(encoded.constData(), static_cast<quint32>(encoded.size()),
+	              !latin1);
+}
+
+void BzardTextArena::release(const Ref &ref) {
+	auto length = ref.length & ~UTF8_FLAG;
+	if (!length)
+		return;
+
+	auto &page = pages[ref.page];
+	page.deadBytes += length;
+	if (!--page.strings && !(opened && ref.page == openPage))
+		freePage(ref.page);
+}
+
+QString BzardTextArena::text(const Ref &ref) const {
+	auto length = static_cast<qsizetype>(ref.length & ~UTF8_FLAG);
+	if (!length)
+		return {};
+
+	auto data = pages[ref.page].bytes.constData() + ref.offset;
+	if (ref.length & UTF8_FLAG)
+		return QString::fromUtf8(data, length);
+	return QString::fromLatin1(data, length);
+}
+
+qint64 BzardTextArena::bytes(const Ref &ref) {
+	return ref.length & ~UTF8_FLAG;
+}
+
+bool BzardTextArena::fragmented() const {
+	for (quint32 i = 0; i < pages.size(); ++i)
+		if (sparse(i))
+			return true;
+	return false;
+}
+
+qint64 BzardTextArena::byteCount() const {
+	return allocated + static_cast<qint64>(pages.capacity() * sizeof(Page));
+}
+
+BzardTextArena::Ref BzardTextArena::append(const char *data, quint32 length,
+                                           bool utf8) {
+	if (!opened || pages[openPage].bytes.size() >= PAGE_BYTES) {
+		if (opened && !pages[openPage].strings)
+			freePage(openPage);
+		if (freePages.empty()) {
+			openPage = static_cast<quint32>(pages.size());
+			pages.emplace_back();
+		} else {
+			openPage = freePages.back();
+			freePages.pop_back();
+		}
+		pages[openPage].bytes.reserve(PAGE_BYTES);
+		allocated += pages[openPage].bytes.capacity();
+		opened = true;
+	}
+
+	auto &page = pages[openPage];
+	auto capacity = page.bytes.capacity();
+	Ref ref{openPage, static_cast<quint32>(page.bytes.size()),
+	        length | (utf8 ? UTF8_FLAG : 0)};
+	page.bytes.append(data, length);
+	++page.strings;
+	allocated += page.bytes.capacity() - capacity;
+	return ref;
+}
+
+// Closed pages with more than half of their bytes released
+bool BzardTextArena::sparse(quint32 page) const {
+	const auto &PAGE = pages[page];
+	if (!PAGE.strings || (opened && page == openPage))
+		return false;
+	return PAGE.deadBytes * 2 > PAGE.bytes.size();
+}
+
+void BzardTextArena::freePage(quint32 page) {
+	auto &freed = pages[page];
+	allocated -= freed.bytes.capacity();
+	freed = {};
+	freePages.push_back(page);
+	if (opened && page == openPage)
+		opened = false;
+}
@@ -0,0 +1,93 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+/*
+ * Append-only pages of compact text. A string is stored as Latin-1 when
+ * every character fits, as UTF-8 otherwise, and is turned back into a
+ * QString only when read.
+ *
+ * A page takes new text until it holds PAGE_BYTES and is freed once all
+ * of its strings are released. Pages left mostly released are compacted
+ * by moving their strings into the open page.
+ */
+class BzardTextArena {
+  public:
+	struct Ref {
+		quint32 page{0};
+		quint32 offset{0};
+		// Byte length, UTF8_FLAG set for UTF-8 text
+		quint32 length{0};
+	};
+
+	Ref add(const QString &TEXT);
+	void release(const Ref &REF);
+	QString text(const Ref &REF) const;
+	static qint64 bytes(const Ref &REF);
+
+	/*
+	 * Moves strings off sparse pages. Visit calls its argument with every
+	 * live Ref, which may be rewritten in place.
+	 */
+	bool fragmented() const;
+	template <typename Visit> void compact(Visit visit);
+
+	qint64 byteCount() const;
+
+  private:
+	struct Page {
+		QByteArray bytes;
+		qint64 deadBytes{0};
+		quint32 strings{0};
+	};
+
+	static constexpr quint32 UTF8_FLAG = 1u << 31;
+	static constexpr qsizetype PAGE_BYTES = 16 * 1024;
+
+	std::vector<Page> pages;
+	std::vector<quint32> freePages;
+	quint32 openPage{0};
+	bool opened{false};
+	qint64 allocated{0};
+
+	Ref append(const char *DATA, quint32 length, bool utf8);
+	bool sparse(quint32 page) const;
+	void freePage(quint32 page);
+};
+
+template <typename Visit> void BzardTextArena::compact(Visit visit) {
+	std::vector<bool> moving(pages.size());
+	for (quint32 i = 0; i < pages.size(); ++i)
+		moving[i] = sparse(i);
+
+	visit([&](Ref &ref) {
+		if (!(ref.length & ~UTF8_FLAG) || !moving[ref.page])
+			return;
+		// Copied first, appending may reallocate the pages
+		auto length = ref.length & ~UTF8_FLAG;
+		auto from = pages[ref.page].bytes.mid(ref.offset, length);
+		auto moved = append(from.constData(), length, ref.length & UTF8_FLAG);
+		release(ref);
+		ref = moved;
+	});
+}
@@ -17,14 +17,13 @@
 
 #include "bzard_themes.h"
 
-#include <QApplication>
+#include <QGuiApplication>
 #include <QScreen>
-#include <QtQml/qqml.h>
 
 namespace {
 static QRect availableGeometry() {
-	QScreen *screen = QApplication::screens().at(0);
-	return screen->availableGeometry();
+	// Themes are sized once, for the screen popups go to by default
+	return QGuiApplication::primaryScreen()->availableGeometry();
 }
 } // namespace
 
@@ -32,7 +31,6 @@ BzardThemes::BzardThemes()
 	  : config{"theme"},
 		themeName{config.value(CONFIG_THEME_NAME, CONFIG_THEME_NAME_DEFAULT)
                         .toString()} {
-	registerThemeTypes();
 	loadTheme(themeConfigFile());
 	auto themeDir = BzardConfig::configDir() + '/' + themeConfigDir();
 	notificationsTheme_ =
@@ -47,6 +45,15 @@ BzardThemes &BzardThemes::instance() {
 	return instance;
 }
 
+BzardThemes *BzardThemes::create(QQmlEngine *engine,
+                                 QJSEngine *scriptEngine) {
+	Q_UNUSED(engine);
+	Q_UNUSED(scriptEngine);
+	// Static, the engine must not delete it
+	QJSEngine::setObjectOwnership(&instance(), QJSEngine::CppOwnership);
+	return &instance();
+}
+
 NotificationsTheme *BzardThemes::notificationsTheme() const {
 	return notificationsTheme_.get();
 }
@@ -69,12 +76,6 @@ void BzardThemes::loadTheme(const QString &fileName) {
 	themeConfig = std::make_shared<BzardConfig>(QString{}, fileName);
 }
 
-void BzardThemes::registerThemeTypes() const {
-	qmlRegisterType<NotificationsTheme>("bzard", 1, 0, "NotificationsTheme");
-	qmlRegisterType<TrayIconTheme>("bzard", 1, 0, "TrayIconTheme");
-	qmlRegisterType<HistoryWindowTheme>("bzard", 1, 0, "HistoryWindowTheme");
-}
-
 BzardTheme::BzardTheme(const std::shared_ptr<BzardConfig> &config_,
                        const QString &themeDir_, QObject *parent)
 	  : QObject(parent), themeConfig{config_}, themeDir{themeDir_} {}
@@ -21,6 +21,7 @@
 
 #include <QColor>
 #include <QObject>
+#include <QQmlEngine>
 #include <QUrl>
 
 #include "bzard_config.h"
@@ -31,6 +32,8 @@ class HistoryWindowTheme;
 
 class BzardThemes : public QObject {
 	Q_OBJECT
+	QML_ELEMENT
+	QML_SINGLETON
 	Q_PROPERTY(NotificationsTheme *notificationsTheme READ notificationsTheme
 	                 CONSTANT)
 	Q_PROPERTY(TrayIconTheme *trayIconTheme READ trayIconTheme CONSTANT)
@@ -40,6 +43,7 @@ class BzardThemes : public QObject {
   public:
 	BzardThemes();
 	static BzardThemes &instance();
+	static BzardThemes *create(QQmlEngine *engine, QJSEngine *scriptEngine);
 
 	NotificationsTheme *notificationsTheme() const;
 	TrayIconTheme *trayIconTheme() const;
@@ -58,7 +62,6 @@ class BzardThemes : public QObject {
 	QString themeConfigDir() const;
 	QString themeConfigFile() const;
 	void loadTheme(const QString &fileName);
-	void registerThemeTypes() const;
 };
 
 class BzardTheme : public QObject {
@@ -77,6 +80,7 @@ class BzardTheme : public QObject {
 
 class NotificationsTheme : public BzardTheme {
 	Q_OBJECT
+	QML_ELEMENT
 
 	Q_PROPERTY(bool iconPosition READ iconPosition CONSTANT)
 	Q_PROPERTY(uint fontSize READ fontSize CONSTANT)
@@ -208,6 +212,7 @@ class NotificationsTheme : public BzardTheme {
 
 class TrayIconTheme : public BzardTheme {
 	Q_OBJECT
+	QML_ELEMENT
 	Q_PROPERTY(QUrl icon READ icon CONSTANT)
   public:
 	using BzardTheme::BzardTheme;
@@ -220,6 +225,7 @@ class TrayIconTheme : public BzardTheme {
 
 class HistoryWindowTheme : public BzardTheme {
 	Q_OBJECT
+	QML_ELEMENT
 	Q_PROPERTY(QUrl closeIcon READ closeIcon CONSTANT)
 	Q_PROPERTY(QUrl bgImage READ bgImage CONSTANT)
 	Q_PROPERTY(QString windowTitle READ windowTitle CONSTANT)
@@ -0,0 +1,88 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bzard_timer_wheel.h"
+
+BzardTimerWheel::BzardTimerWheel(qint64 now, qint64 tick_)
+	  : tick{tick_}, cursor{now / tick_} {}
+
+bool BzardTimerWheel::contains(IdT id) const {
+	return positions.contains(id);
+}
+
+bool BzardTimerWheel::empty() const {
+	return positions.isEmpty();
+}
+
+void BzardTimerWheel::schedule(IdT id, qint64 deadline) {
+	cancel(id);
+	// Rounded up, never in a tick already processed
+	auto ticks = qMax((deadline + tick - 1) / tick, cursor + 1);
+	place({id, ticks});
+}
+
+bool BzardTimerWheel::cancel(IdT id) {
+	auto found = positions.find(id);
+	if (found == positions.end())
+		return false;
+
+	auto position = *found;
+	positions.erase(found);
+	--counts[position.level];
+	auto &slot = levels[position.level][position.slot];
+	if (position.index + 1 != slot.size()) {
+		slot[position.index] = slot.back();
+		positions[slot[position.index].id].index = position.index;
+	}
+	slot.pop_back();
+	return true;
+}
+
+void BzardTimerWheel::place(const Entry &ENTRY) {
+	// The lowest level whose span still reaches the deadline
+	auto level = 0;
+	auto shift = 0;
+	while (level + 1 < LEVELS &&
+	       (ENTRY.tick >> shift) - (cursor >> shift) >= SLOTS) {
+		++level;
+		shift += LEVEL_BITS;
+	}
+	auto block = ENTRY.tick >> shift;
+	// Past the top level, parked in its last slot and placed again later
+	if (block - (cursor >> shift) >= SLOTS)
+		block = (cursor >> shift) + SLOTS - 1;
+
+	auto slotIndex = static_cast<int>(block & (SLOTS - 1));
+	auto &slot = levels[level][slotIndex];
+	positions.insert(ENTRY.id, {level, slotIndex, slot.size()});
+	++counts[level];
+	slot.push_back(ENTRY);
+}
+
+void BzardTimerWheel::cascade(int level, int slot) {
+	for (const auto &ENTRY : take(level, slot))
+		place(ENTRY);
+}
+
+BzardTimerWheel::SlotT BzardTimerWheel::take(int level, int slot) {
+	SlotT entries;
+	entries.swap(levels[level][slot]);
+	counts[level] -= entries.size();
+	for (const auto &ENTRY : entries)
+		positions.remove(ENTRY.id);
+	return entries;
+}
@@ -0,0 +1,115 @@
+/*
+ *     This file is part of bzard.
+ *
+ * bzard is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * bzard is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bzard.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <QHash>
+
+#include "bzard_notification.h"
+
+/*
+ * Hierarchical timing wheel of notification deadlines, in milliseconds of
+ * a monotonic clock. Each level has 64 slots, each slot of a level spans
+ * the whole lower level; deadlines move down a level when the wheel
+ * reaches their slot. Scheduling and cancelling cost O(1), advancing
+ * costs O(1) per tick plus O(1) per cascaded or expired deadline.
+ */
+class BzardTimerWheel {
+  public:
+	using IdT = BzardNotification::IdT;
+
+	// Deadlines are rounded up to whole ticks of TICK milliseconds
+	explicit BzardTimerWheel(qint64 now, qint64 tick_ = 10);
+
+	bool contains(IdT id) const;
+	bool empty() const;
+
+	// Replaces the deadline of id if it has one
+	void schedule(IdT id, qint64 deadline);
+	bool cancel(IdT id);
+
+	// Calls expire(id) for every deadline up to now, earliest tick first
+	template <typename Expire> void advance(qint64 now, Expire expire);
+
+  private:
+	static constexpr int LEVEL_BITS = 6;
+	static constexpr int SLOTS = 1 << LEVEL_BITS;
+	static constexpr int LEVELS = 4;
+
+	struct Entry {
+		IdT id;
+		qint64 tick;
+	};
+	struct Position {
+		int level;
+		int slot;
+		size_t index;
+	};
+	using SlotT = std::vector<Entry>;
+
+	const qint64 tick;
+	// Last tick processed
+	qint64 cursor;
+	std::array<std::array<SlotT, SLOTS>, LEVELS> levels;
+	// Deadlines per level, so idle stretches are skipped
+	std::array<size_t, LEVELS> counts{};
+	QHash<IdT, Position> positions;
+
+	void place(const Entry &ENTRY);
+	// Moves the deadlines of a slot down to where they belong now
+	void cascade(int level, int slot);
+	SlotT take(int level, int slot);
+};
+
+template <typename Expire>
+void BzardTimerWheel::advance(qint64 now, Expire expire) {
+	auto target = now / tick;
+	while (cursor < target) {
+		if (positions.isEmpty()) {
+			cursor = target;
+			return;
+		}
+		// Nothing fires before the lowest non-empty level wraps
+		auto empty = 0;
+		while (counts[empty] == 0)
+			++empty;
+		if (empty) {
+			auto last = cursor | ((qint64{1} << (empty * LEVEL_BITS)) - 1);
+			if (last >= target) {
+				cursor = target;
+				return;
+			}
+			cursor = last;
+		}
+
+		++cursor;
+		auto first = static_cast<int>(cursor & (SLOTS - 1));
+		// A wrapped level pulls the next slot of the level above
+		auto wrapped = first == 0;
+		for (int level = 1; wrapped && level < LEVELS; ++level) {
+			auto slot = static_cast<int>((cursor >> (level * LEVEL_BITS)) &
+			                             (SLOTS - 1));
+			cascade(level, slot);
+			wrapped = slot == 0;
+		}
+		for (const auto &ENTRY : take(0, first))
+			expire(ENTRY.id);
+	}
+}
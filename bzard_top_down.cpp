@@ -17,12 +17,15 @@
 
 #include "bzard_top_down.h"
 
-BzardTopDown::BzardTopDown(QObject *parent) : BzardDisposition(parent) {
+BzardTopDown::BzardTopDown(QScreen *screen, QObject *parent)
+	  : BzardDisposition(screen, parent) {
 	recalculateAvailableScreenGeometry();
 }
 
 BzardTopDown::Optional<QPoint> BzardTopDown::poses(BzardNotification::IdT id,
                                                    QSize size) {
+	flushReflow();
+
 	// Already here, must be replaced
 	auto currentPosition = dispositions.find(id);
 	if (currentPosition != dispositions.end())
@@ -69,44 +72,17 @@ void BzardTopDown::setSpacing(int value) {
 }
 
 void BzardTopDown::remove(BzardNotification::IdT id) {
-	static auto recalculateDispositions = [this](const auto &TO_REMOVE_IT)
-		  -> std::map<BzardNotification::IdT, QPoint> {
-		auto end = dispositions.end();
-		const QRect &TO_REMOVE = TO_REMOVE_IT->second;
-		auto moveUpFor = spacing + TO_REMOVE.height();
-
-		auto remove = std::next(TO_REMOVE_IT);
-		if (remove == end) {
-			return {};
-		}
-		std::map<BzardNotification::IdT, QPoint> positionToMove;
-		for (; remove != end; ++remove) {
-			auto dId = remove->first;
-			auto &dPosition = remove->second;
-			dPosition.moveTop(dPosition.top() - moveUpFor);
-			positionToMove.emplace(dId, dPosition.topLeft());
-		}
-		return positionToMove;
-	};
-
-	auto position = dispositions.find(id);
-	if (position != dispositions.end()) {
-		// Just calculate all
-		auto positionToMove = recalculateDispositions(position);
-		// Now move
-		for (auto &move : positionToMove)
-			emit moveNotification(move.first, move.second);
-
-		// pos_it will not be invalidated even
-		// if posess will be called before next line
-		dispositions.erase(position);
-	} else {
-		//		throw std::runtime_error{
-		//		    "BzardTopDown: can't find old disposition"};
+	// The rest move up once the event loop pass is over
+	if (dispositions.erase(id)) {
+		forgetMove(id);
+		scheduleReflow();
 	}
 }
 
-void BzardTopDown::removeAll() { dispositions.clear(); }
+void BzardTopDown::removeAll() {
+	dispositions.clear();
+	cancelReflow();
+}
 
 void BzardTopDown::recalculateAvailableScreenGeometry() {
 	BzardDisposition::recalculateAvailableScreenGeometry();
@@ -114,17 +90,43 @@ void BzardTopDown::recalculateAvailableScreenGeometry() {
 	availableScreenGeometry -= QMargins{0, 0, 0, extraBottomMargin};
 }
 
+// Stacks what is left from the top, in the order popups came
+void BzardTopDown::reflow() {
+	auto top = availableScreenGeometry.top();
+	auto overflow = dispositions.end();
+	for (auto disposition = dispositions.begin();
+	     disposition != dispositions.end(); ++disposition) {
+		auto &rect = disposition->second;
+		QPoint topLeft{availableScreenGeometry.right() + 1 - rect.width(),
+		               top};
+		if (!availableScreenGeometry.contains(QRect{topLeft, rect.size()})) {
+			overflow = disposition;
+			break;
+		}
+		if (rect.topLeft() != topLeft) {
+			rect.moveTopLeft(topLeft);
+			moveTo(disposition->first, topLeft);
+		}
+		top = rect.bottom() + 1 + spacing;
+	}
+
+	// Only a shrunk screen leaves popups past the bottom
+	while (overflow != dispositions.end()) {
+		auto id = overflow->first;
+		overflow = dispositions.erase(overflow);
+		forgetMove(id);
+		emit overflowed(id);
+	}
+}
+
+void BzardTopDown::relayout() { scheduleReflow(); }
+
 QRect BzardTopDown::availableGeometry() const {
 	auto result = availableScreenGeometry;
-	result.adjust(0, dispositions.empty() ? 0 : spacing, 0, 0);
-
 	if (dispositions.empty())
 		return result;
 
 	const auto &LAST_OBJECT = *std::crbegin(dispositions);
-
-	// Top margin already included in availableScreenGeometry
-	auto bottomMargin = LAST_OBJECT.second.bottom() - margins.top();
-	result.adjust(0, bottomMargin, 0, 0);
+	result.setTop(LAST_OBJECT.second.bottom() + 1 + spacing);
 	return result;
 }
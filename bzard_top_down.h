@@ -30,7 +30,8 @@ class BzardTopDown final : public BzardDisposition {
   public:
 	using BzardDisposition::Optional;
 
-	explicit BzardTopDown(QObject *parent = nullptr);
+	explicit BzardTopDown(QScreen *screen = nullptr,
+	                      QObject *parent = nullptr);
 
 	Optional<QPoint> poses(BzardNotification::IdT id, QSize size) final;
 
@@ -48,5 +49,7 @@ class BzardTopDown final : public BzardDisposition {
 	std::map<BzardNotification::IdT, QRect> dispositions;
 
 	void recalculateAvailableScreenGeometry() final;
+	void reflow() final;
+	void relayout() final;
 	QRect availableGeometry() const;
 };
@@ -18,11 +18,13 @@
 #pragma once
 
 #include <QObject>
+#include <QQmlEngine>
 #include <QSystemTrayIcon>
 #include <QUrl>
 
 class BzardTrayIcon : public QSystemTrayIcon {
 	Q_OBJECT
+	QML_ELEMENT
 	Q_PROPERTY(QUrl iconUrl READ iconUrl WRITE setIconUrl NOTIFY iconUrlChanged)
   public:
 	explicit BzardTrayIcon(QObject *parent = nullptr);
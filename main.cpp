@@ -16,37 +16,37 @@
  */
 
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
 #include <QQmlApplicationEngine>
 #include <QtDBus/QDBusConnection>
 #include <QtQml>
 
+#include "historyadaptor.h"
 #include "notificationsadaptor.h"
 
 #include "bzard_dbus_service.h"
-#include "bzard_expiration_controller.h"
+#include "bzard_disposition_factory.h"
 #include "bzard_history.h"
+#include "bzard_icon_cache.h"
+#include "bzard_incubation_controller.h"
 #include "bzard_notification_modifiers.h"
 #include "bzard_notifications.h"
-#include "bzard_themes.h"
-#include "bzard_top_down.h"
-#include "bzard_tray_icon.h"
 
 #ifdef BZARD_X11
 #include "X11-plugin/x11fullscreendetector.h"
 #endif
 
+Q_LOGGING_CATEGORY(startup_timing, "bzard.startup.timing", QtWarningMsg)
+
 static BzardDBusService *get_service();
 static BzardHistory *get_history();
 static QDBusConnection connect_to_session_bus(BzardDBusService *service);
-static QObject *bzardnotifications_provider(QQmlEngine *engine,
-                                            QJSEngine *scriptEngine);
-static QObject *bzardthemes_provider(QQmlEngine *engine,
-                                     QJSEngine *scriptEngine);
 
 BzardDBusService *get_service() {
 	using namespace BzardNotificationModifiers;
 
-	auto disposition = std::make_unique<BzardTopDown>();
+	auto disposition = BzardDispositionFactory{}.create();
 	auto dbus_service =
 		  (new BzardDBusService)
 				->addModifier(make<IDGenerator>())
@@ -71,27 +71,7 @@ BzardDBusService *get_service() {
 }
 
 BzardHistory *get_history() {
-	static BzardHistory history;
-	return &history;
-}
-
-QObject *bzardnotifications_provider(QQmlEngine *engine,
-                                     QJSEngine *scriptEngine) {
-	Q_UNUSED(engine);
-	Q_UNUSED(scriptEngine);
-	return BzardNotifications::get();
-}
-
-QObject *bzardthemes_provider(QQmlEngine *engine, QJSEngine *scriptEngine) {
-	Q_UNUSED(engine);
-	Q_UNUSED(scriptEngine);
-	return &BzardThemes::instance();
-}
-
-QObject *bzardhistory_provider(QQmlEngine *engine, QJSEngine *scriptEngine) {
-	Q_UNUSED(engine);
-	Q_UNUSED(scriptEngine);
-	return get_history();
+	return &BzardHistory::instance();
 }
 
 QDBusConnection connect_to_session_bus(BzardDBusService *service) {
@@ -105,6 +85,13 @@ QDBusConnection connect_to_session_bus(BzardDBusService *service) {
 	if (!connection.registerObject("/org/freedesktop/Notifications", service)) {
 		throw std::runtime_error{"Can't register DBus service object!"};
 	}
+
+	auto history = get_history();
+	if (history->isEnabled()) {
+		new HistoryAdaptor(history);
+		if (!connection.registerObject("/org/bzard/History", history))
+			qWarning() << "Can't register DBus history object!";
+	}
 	return connection;
 }
 
@@ -112,26 +99,26 @@ int main(int argc, char *argv[]) {
 	if (qgetenv("XDG_SESSION_TYPE") == QByteArray("wayland"))
 		qputenv("QT_WAYLAND_SHELL_INTEGRATION", QByteArray("layer-shell"));
 
+	QElapsedTimer startup;
+	startup.start();
 	QApplication app(argc, argv);
 	app.setQuitOnLastWindowClosed(false);
 
 	auto dbus_service = get_service();
 	connect_to_session_bus(dbus_service);
 
-	qmlRegisterSingletonType<BzardThemes>("bzard", 1, 0, "BzardThemes",
-	                                      bzardthemes_provider);
-	qmlRegisterType<BzardExpirationController>("bzard", 1, 0,
-	                                           "BzardExpirationController");
-	qmlRegisterType<BzardTrayIcon>("bzard", 1, 0, "BzardTrayIcon");
-	qmlRegisterSingletonType<BzardNotifications>(
-		  "bzard", 1, 0, "BzardNotifications", bzardnotifications_provider);
-	qmlRegisterSingletonType<BzardHistory>("bzard", 1, 0, "BzardHistory",
-	                                       bzardhistory_provider);
-
+	// Declared first, the engine must not outlive it
+	BzardIncubationController incubationController;
 	QQmlApplicationEngine engine;
-	engine.load(QUrl(QStringLiteral("qrc:/main.qml")));
+	engine.setIncubationController(&incubationController);
+	// Engine takes ownership of the provider
+	engine.addImageProvider(BzardIconCache::PROVIDER_ID, new BzardIconCache);
+	// QML types are registered by the bzard module, compiled ahead of time
+	engine.load(QUrl(QStringLiteral("qrc:/qt/qml/bzard/main.qml")));
 	if (engine.rootObjects().isEmpty())
 		return -1;
+	qCDebug(startup_timing) << "main.qml loaded" << startup.elapsed()
+	                        << "ms after start";
 
 	return app.exec();
 }
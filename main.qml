@@ -17,115 +17,216 @@
 
 import QtQuick.Window
 import QtQuick
+import QtQml.Models
 import bzard 1.0
 
 QtObject {
     id: root
-    property var notificationsMap: {'-1': Object} // that's ok
-    property var cons: Connections {
-        target: BzardNotifications
-        function onCreateNotification (notification_id, size, pos,expire_timeout,                                             appName,
-                                       body, title,
-                                       iconUrl, actions) {
-            if (notificationsMap[notification_id]) {
-//                notificationsMap[notification_id].body = body;
-//                notificationsMap[notification_id].title = title;
-//                return;
-                notification_id.expiration_timeout = 0;
-                dropNotification(notification_id);
-            }
-
-            var n = root.createNotification(notification_id,
-                                            size, pos,
-                                            expire_timeout,
-                                            appName,
-                                            body, title,
-                                            iconUrl, actions);
-            n.show();
-            root.addNotification(notification_id, n);
-        }
-        function onDropNotification (notification_id) {
-            root.dropNotification(notification_id);
-        }
-        function onDropAllVisible () {
-            root.dropAllVisible()
-        }
-        function onMoveNotification (notification_id, pos) {
-            root.moveNotification(notification_id, pos);
-        }
-    }
+    property Component notificationComponent: null
+    // Hidden popups ready to be bound to a notification
+    property var popupPool: []
+    // Window shared by all popups when BzardNotifications.singleOverlay
+    property var overlay: null
 
     Component.onCompleted: {
         initExtraNotifications();
+        if (BzardNotifications.singleOverlay)
+            initOverlay();
+        warmPopupPool();
     }
 
-    function actionsToButtons(actions) {
-        var buttons = [];
-        for (var i = 0; i < actions.length; i += 2) {
-            buttons.push({
-                             "action": actions[i],
-                             "text": actions[i+1]
-                         });
+    /* LIVE POPUPS */
+
+    // One binding per row of BzardNotifications.popups, holding its popup
+    property var popups__: Instantiator {
+        model: BzardNotifications.popups
+        delegate: QtObject {
+            id: binding
+            required property int notificationId
+            required property size size
+            required property point position
+            required property int expireTimeout
+            required property string appName
+            required property string title
+            required property string body
+            required property string iconUrl
+            required property var buttons
+            required property bool alive
+            required property int revision
+
+            // Null until a pooled or incubated popup is handed over
+            property var popup: null
+            property double requestedAt: 0
+
+            Component.onCompleted: {
+                requestedAt = Date.now();
+                root.requestPopup(binding);
+            }
+            Component.onDestruction: {
+                if (popup)
+                    root.releasePopup(popup);
+                else
+                    root.cancelPopupRequest(binding);
+            }
+
+            function attach(popup_, pooled) {
+                popup = popup_;
+                popup.requestedAt = requestedAt;
+                popup.pooled = pooled;
+                popup.notification_id = notificationId;
+                popup.width = size.width;
+                popup.referenceHeight = size.height;
+                popup.x = position.x - root.originX();
+                popup.y = position.y - root.originY();
+                popup.expireTimeout = expireTimeout;
+                popup.appName = appName;
+                popup.body = body;
+                popup.title = title;
+                popup.iconUrl = iconUrl;
+                popup.buttons = buttons;
+                popup.show();
+                if (!alive)
+                    popup.drop();
+            }
+
+            onPositionChanged: {
+                if (popup)
+                    popup.move(position.x - root.originX(),
+                               position.y - root.originY());
+            }
+            onExpireTimeoutChanged: if (popup) popup.expireTimeout = expireTimeout
+            onAppNameChanged: if (popup) popup.appName = appName
+            onTitleChanged: if (popup) popup.title = title
+            onBodyChanged: if (popup) popup.body = body
+            onIconUrlChanged: if (popup) popup.iconUrl = iconUrl
+            onButtonsChanged: if (popup) popup.buttons = buttons
+            // Once every role of the update has been applied
+            onRevisionChanged: Qt.callLater(binding.restartExpiration)
+            onAliveChanged: {
+                if (alive)
+                    return;
+                if (popup)
+                    popup.drop();
+                else // Nothing shown yet, nothing to animate
+                    BzardNotifications.onPopupReleased(notificationId);
+            }
+
+            function restartExpiration() {
+                if (popup)
+                    popup.restartExpiration();
+            }
+
+            property var released__: Connections {
+                target: binding.popup
+                function onReleased() {
+                    BzardNotifications.onPopupReleased(binding.notificationId);
+                }
+            }
         }
-        return buttons;
     }
 
-    function createNotification(notification_id,
-                                size, pos,
-                                expire_timeout,
-                                appName,
-                                body,title,
-                                iconUrl, actions) {
-        var component = Qt.createComponent("BzardNotification.qml");
-        if (component.status !== Component.Ready) {
-            if(component.status === Component.Error)
-                console.debug("Error: "+ component.errorString());
-            throw "Can't create notification!";
+    /* POPUP POOL */
+
+    // Bindings waiting for a popup, oldest first, so popups show in order
+    property var popupRequests: []
+    property int incubatingPopups: 0
+
+    function popupComponent() {
+        if (notificationComponent === null) {
+            var component = Qt.createComponent(overlay ?
+                                                   "BzardOverlayNotification.qml" :
+                                                   "BzardNotification.qml");
+            if (component.status !== Component.Ready) {
+                if(component.status === Component.Error)
+                    console.debug("Error: "+ component.errorString());
+                throw "Can't create notification!";
+            }
+            notificationComponent = component;
         }
-        var options = {
-            "notification_id": notification_id,
-            "width": size.width,
-            "height": size.height,
-            "x": pos.x, "y": pos.y,
-            "expireTimeout": expire_timeout,
-            "appName": appName,
-            "body": body,
-            "title": title,
-            "iconUrl": iconUrl,
-            "buttons": actionsToButtons(actions)
+        return notificationComponent;
+    }
+
+    // Built a slice per frame by BzardIncubationController
+    function incubatePopup() {
+        var incubator = popupComponent().incubateObject(overlay ?
+                                                            overlay.contentItem :
+                                                            root, {
+                                                            "visible": false,
+                                                            "recyclable": true
+                                                        }, Qt.Asynchronous);
+        ++incubatingPopups;
+        var incubated = function(status) {
+            if (status === Component.Loading)
+                return;
+            --incubatingPopups;
+            if (status === Component.Ready)
+                providePopup(incubator.object, false);
+            else
+                console.debug("Error creating notification object");
         };
-        var notification = component.createObject(root,
-                                                  options);
-        if (notification === null)
-            throw "Error creating notification object";
-        return notification;
+        if (incubator.status !== Component.Loading)
+            incubated(incubator.status);
+        else
+            incubator.onStatusChanged = incubated;
     }
 
-    function addNotification(notification_id, notification) {
-        notificationsMap[notification_id] = notification;
+    function warmPopupPool() {
+        for (var i = popupPool.length + incubatingPopups;
+             i < BzardNotifications.popupPoolSize; ++i)
+            incubatePopup();
     }
 
-    function dropNotification(notification_id) {
-        if (notificationsMap[notification_id] !== undefined) {
-            notificationsMap[notification_id].drop();
-            notificationsMap[notification_id] = undefined;
+    function requestPopup(binding) {
+        if (popupRequests.length === 0 && popupPool.length > 0) {
+            binding.attach(popupPool.pop(), true);
+            return;
         }
+        popupRequests.push(binding);
+        if (incubatingPopups < popupRequests.length)
+            incubatePopup();
     }
 
-    function dropAllVisible() {
-        Object.keys(notificationsMap).forEach(function(key) {
-            if( key != '-1') {
-//                BzardNotifications.onDropNotification(key);
-                dropNotification(key);
-            }
+    function cancelPopupRequest(binding) {
+        var index = popupRequests.indexOf(binding);
+        if (index >= 0)
+            popupRequests.splice(index, 1);
+    }
 
-        });
+    function providePopup(popup, pooled) {
+        if (popupRequests.length > 0) {
+            popupRequests.shift().attach(popup, pooled);
+        } else if (popupPool.length < BzardNotifications.popupPoolSize) {
+            popup.notification_id = 0;
+            popupPool.push(popup);
+        } else {
+            popup.destroy();
+        }
+    }
+
+    function releasePopup(popup) {
+        popup.reset();
+        providePopup(popup, true);
     }
 
-    function moveNotification(notification_id, pos) {
-        if (notificationsMap[notification_id] !== undefined) {
-            notificationsMap[notification_id].move(pos.x, pos.y);
+    /* SINGLE OVERLAY */
+
+    function initOverlay() {
+        var component = Qt.createComponent("BzardOverlay.qml");
+        if (component.status !== Component.Ready) {
+            if(component.status === Component.Error)
+                console.debug("Error: "+ component.errorString());
+            throw "Can't create overlay window!";
         }
+        overlay = component.createObject(root, {});
+    }
+
+    // Dispositions place popups in screen coordinates
+    function originX() {
+        return overlay ? overlay.origin.x : 0;
+    }
+
+    function originY() {
+        return overlay ? overlay.origin.y : 0;
     }
 
     function initExtraNotifications () {